@@ -0,0 +1,11 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/*
+  Counts calls to the global operator new so main() can check that a search reusing a NodePool does not allocate.
+  The replacement operators live in allocation_count.cpp: kept out of line, GCC cannot inline a delete that calls
+  std::free() into code whose new it sees as the library's and warn about a mismatched pair (-Wmismatched-new-delete).
+*/
+extern std::atomic<std::size_t> allocation_count;
@@ -0,0 +1,150 @@
+#ifndef BIDIRECTIONAL_H
+#define BIDIRECTIONAL_H
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+#include "types.h"
+#include "grid_planning.h"
+
+using std::vector;
+
+/*
+  Bidirectional A*: one frontier grows from the start towards the goal and one from the goal towards the start, each
+  guided by the connectivity's heuristic to the opposite end (front-to-end).
+
+  It pays off when one end sits in a large region the heuristic leads into a dead end, e.g. a room whose door faces
+  away from the goal while the goal side is a narrow corridor: PlanPath() floods the whole room before it finds the
+  door, while here the backward frontier stays small, so it gets most of the expansions and walks in through the door.
+  On mazes and open fields it expands about twice as many nodes as PlanPath(): Manhattan distance misleads both
+  sides equally, and on open ground the two depth-first frontiers take different staircases and pass each other.
+  Measured alternatives (alternating by smaller top f, averaged "balanced" heuristics with the kF + kB >= mu stop)
+  narrowed the maze gap but lost most of the dead-end advantage, so the simple front-to-end form is kept.
+
+  mu is the cost of the best start -> goal path found so far through a tile reached by both frontiers. Expanding a
+  node never produces a path cheaper than its f, so once the smallest f on either open list reaches mu no cheaper
+  meeting point can exist and mu is optimal (this needs a consistent heuristic, which Connectivity::Heuristic is).
+
+  The frontiers alternate on one thread, always expanding the side with the smaller open list. Two threads would need
+  a lock or atomics on every best-g lookup across sides, which costs more than it saves on grid-sized problems.
+*/
+
+struct BidirectionalPools {
+  NodePool forward;
+  NodePool backward;
+};
+
+template <typename Connectivity = FourConnected, typename CostModel>
+bool PlanPathBidirectional(const CostModel& cost, const Coordinate& start, const Coordinate& goal, BidirectionalPools& pools,
+                           PathResult& result) {
+  result.found = false;
+  result.cost = 0;
+  result.expanded = 0;
+  result.cells.clear();
+  const CellIndex index(cost.Rows(), cost.Cols());
+  if (!index.Fits()) {
+    LOG_WARNING("A {}x{} board has more tiles than the planner can index.", cost.Rows(), cost.Cols());
+    return false;
+  }
+  if (!Passable(cost, start.x, start.y) || !Passable(cost, goal.x, goal.y)) return false;
+
+  const auto cells = index.Count();
+  const auto start_cell = index(start.x, start.y);
+  const auto goal_cell = index(goal.x, goal.y);
+
+  auto& forward = pools.forward;
+  auto& backward = pools.backward;
+  forward.Begin(cells);
+  backward.Begin(cells);
+  forward.Open(start_cell, 0, -1);
+  forward.Push(PackedNode {start_cell, 0, Connectivity::Heuristic(start, goal)});
+  backward.Open(goal_cell, 0, -1);
+  backward.Push(PackedNode {goal_cell, 0, Connectivity::Heuristic(goal, start)});
+
+  int mu = start_cell == goal_cell ? 0 : INT_MAX;
+  int meet = start_cell == goal_cell ? static_cast<int>(start_cell) : -1;
+
+  // Drops entries superseded by a cheaper push or already expanded, so Top() is a valid lower bound
+  const auto skim = [](NodePool& pool) {
+    while (!pool.Empty() && (pool.Closed(pool.Top().cell) || pool.Top().g > pool.BestG(pool.Top().cell))) pool.Pop();
+  };
+
+  /*
+    Expands one node of `side`. Forward edges cost the weight of the tile being entered; the backward frontier walks
+    edges in reverse, so a backward move from v to u costs the weight of v, the tile being left.
+  */
+  const auto expand = [&](NodePool& side, NodePool& other, bool is_forward) {
+    auto current = side.Pop();
+    side.Close(current.cell);
+    result.expanded++;
+
+    const auto here = index.At(current.cell);
+    const int x = here.x;
+    const int y = here.y;
+    const auto& target = is_forward ? goal : start;
+    for (int direction = 0; direction < Connectivity::kDirections; direction++) {
+      const auto dx = Connectivity::kDelta[direction][0];
+      const auto dy = Connectivity::kDelta[direction][1];
+      if (!Passable(cost, x + dx, y + dy)) continue;
+
+      auto step = Connectivity::kStraightCost;
+      if constexpr (Connectivity::kDirections == 8) {
+        if (dx != 0 && dy != 0) {
+          auto side_a = Passable(cost, x + dx, y);
+          auto side_b = Passable(cost, x, y + dy);
+          if (Connectivity::kCutCorners ? !(side_a || side_b) : !(side_a && side_b)) continue;
+          step = Connectivity::kDiagonalCost;
+        }
+      }
+      if constexpr (!CostModel::kUniform) {
+        step *= is_forward ? cost(x + dx, y + dy) : cost(x, y);
+      }
+
+      auto g = current.g + step;
+      auto neighbor_cell = index(x + dx, y + dy);
+      if (g < side.BestG(neighbor_cell)) {
+        side.Open(neighbor_cell, g, static_cast<int>(current.cell));
+        side.Push(PackedNode {neighbor_cell, g, g + Connectivity::Heuristic(Coordinate {x + dx, y + dy}, target)});
+        if (other.Reached(neighbor_cell) && g + other.BestG(neighbor_cell) < mu) {
+          mu = g + other.BestG(neighbor_cell);
+          meet = static_cast<int>(neighbor_cell);
+        }
+      }
+    }
+  };
+
+  while (true) {
+    skim(forward);
+    skim(backward);
+    if (forward.Empty() || backward.Empty()) break;
+    if (std::max(forward.Top().f, backward.Top().f) >= mu) break;
+
+    if (forward.OpenSize() <= backward.OpenSize()) expand(forward, backward, true);
+    else expand(backward, forward, false);
+  }
+
+  if (meet == -1) return false;
+
+  result.found = true;
+  result.cost = mu;
+  for (auto i = meet; i != -1; i = forward.Parent(i)) {
+    result.cells.push_back(index.At(i));
+  }
+  std::reverse(result.cells.begin(), result.cells.end());
+  for (auto i = backward.Parent(meet); i != -1; i = backward.Parent(i)) {
+    result.cells.push_back(index.At(i));
+  }
+  return true;
+}
+
+template <typename Connectivity = FourConnected, typename CostModel>
+PathResult PlanPathBidirectional(const CostModel& cost, const Coordinate& start, const Coordinate& goal) {
+  BidirectionalPools pools;
+  PathResult result;
+  PlanPathBidirectional<Connectivity>(cost, start, goal, pools, result);
+  return result;
+}
+
+#endif // BIDIRECTIONAL_H
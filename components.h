@@ -0,0 +1,191 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <vector>
+#include <numeric>
+#include <future>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+
+#include "types.h"
+#include "planning.h"
+#include "logger.h"
+
+using std::vector;
+
+/*
+  Connected-component labels for the free tiles of a board (4-connected, matching Search()).
+
+  Two tiles are mutually reachable exactly when they have the same label, so an unreachable start/goal pair is
+  rejected in O(1) instead of letting Search() exhaust the whole region around the start.
+
+  Labelling runs at load time with a union-find over the board:
+    1. the rows are split into bands and each band is labelled on its own thread (unions stay inside the band),
+    2. the seams between neighbouring bands are merged on the calling thread.
+
+  Updates are incremental:
+    Blocked -> Free   the tile is unioned with its free neighbours, nearly O(1).
+    Free -> Blocked   may split a component, which union-find cannot undo, so the old component is relabelled with
+                      a flood fill. The cost is proportional to that component only, not to the board.
+*/
+class ConnectedComponents {
+public:
+  static constexpr int kNone = -1;
+
+  ConnectedComponents() = default;
+
+  explicit ConnectedComponents(const vector<vector<TileState>>& board)
+    : rows_{static_cast<int>(board.size())}, cols_{board.empty() ? 0 : static_cast<int>(board[0].size())} {
+    free_.resize(Cells());
+    for (int x = 0; x < rows_; x++) {
+      for (int y = 0; y < cols_; y++) free_[Index(x, y)] = board[x][y] != TileState::Blocked;
+    }
+    parent_.resize(Cells());
+    std::iota(parent_.begin(), parent_.end(), 0);
+
+    auto threads = std::max(1u, std::thread::hardware_concurrency());
+    auto bands = std::max(1, std::min<int>(threads, rows_ / 64));
+    auto band_rows = (rows_ + bands - 1) / std::max(1, bands);
+
+    vector<std::future<void>> futures;
+    for (int first = band_rows; first < rows_; first += band_rows) {
+      futures.emplace_back(std::async(std::launch::async, &ConnectedComponents::UnionRows, this, first, std::min(rows_, first + band_rows)));
+    }
+    UnionRows(0, std::min(rows_, band_rows));
+    for (auto& future : futures) future.wait();
+
+    // Seams: the first row of each band against the last row of the band above it
+    for (int x = band_rows; x < rows_; x += band_rows) {
+      for (int y = 0; y < cols_; y++) {
+        if (free_[Index(x, y)] && free_[Index(x - 1, y)]) Union(Index(x, y), Index(x - 1, y));
+      }
+    }
+  }
+
+  int Label(const Coordinate& c) {
+    if (!InBounds(c) || !free_[Index(c.x, c.y)]) return kNone;
+    return Find(Index(c.x, c.y));
+  }
+
+  bool Connected(const Coordinate& a, const Coordinate& b) {
+    auto label = Label(a);
+    return label != kNone && label == Label(b);
+  }
+
+  void SetTile(const Coordinate& c, TileState state) {
+    if (!InBounds(c)) return;
+    auto cell = Index(c.x, c.y);
+    bool now_free = state != TileState::Blocked;
+    if (now_free == static_cast<bool>(free_[cell])) return;
+
+    if (now_free) {
+      free_[cell] = true;
+      parent_[cell] = cell;
+      for (auto& d : delta) {
+        auto neighbor = Coordinate {c.x + d[0], c.y + d[1]};
+        if (InBounds(neighbor) && free_[Index(neighbor.x, neighbor.y)]) Union(cell, Index(neighbor.x, neighbor.y));
+      }
+      return;
+    }
+
+    /*
+      Every tile of the old component is connected to the blocked tile through one of its free neighbours, so flooding
+      from those (at most four) neighbours revisits exactly the old component and re-roots each piece at its seed.
+      Tiles outside the old component are untouched.
+    */
+    free_[cell] = false;
+    parent_[cell] = cell;
+    if (flood_stamp_.size() != parent_.size() || flood_mark_ == UINT32_MAX) {
+      flood_stamp_.assign(parent_.size(), 0);
+      flood_mark_ = 0;
+    }
+    flood_mark_++;
+
+    vector<int> stack;
+    for (auto& d : delta) {
+      auto seed_coordinate = Coordinate {c.x + d[0], c.y + d[1]};
+      if (!InBounds(seed_coordinate)) continue;
+      auto seed = Index(seed_coordinate.x, seed_coordinate.y);
+      if (!free_[seed] || flood_stamp_[seed] == flood_mark_) continue;
+
+      flood_stamp_[seed] = flood_mark_;
+      parent_[seed] = seed;
+      stack.push_back(seed);
+      while (!stack.empty()) {
+        auto i = stack.back();
+        stack.pop_back();
+        for (auto& e : delta) {
+          auto neighbor = Coordinate {i / cols_ + e[0], i % cols_ + e[1]};
+          if (!InBounds(neighbor)) continue;
+          auto j = Index(neighbor.x, neighbor.y);
+          if (free_[j] && flood_stamp_[j] != flood_mark_) {
+            flood_stamp_[j] = flood_mark_;
+            parent_[j] = seed;
+            stack.push_back(j);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  int rows_ {0};
+  int cols_ {0};
+  vector<int> parent_;
+  vector<char> free_;
+  // Marks tiles already reached by the current relabelling flood fill
+  vector<uint32_t> flood_stamp_;
+  uint32_t flood_mark_ {0};
+
+  int Cells() const { return rows_ * cols_; }
+  int Index(int x, int y) const { return x * cols_ + y; }
+  bool InBounds(const Coordinate& c) const { return c.x >= 0 && c.x < rows_ && c.y >= 0 && c.y < cols_; }
+
+  int Find(int i) {
+    // Path halving: every visited tile is pointed at its grandparent
+    while (parent_[i] != i) {
+      parent_[i] = parent_[parent_[i]];
+      i = parent_[i];
+    }
+    return i;
+  }
+
+  void Union(int a, int b) {
+    a = Find(a);
+    b = Find(b);
+    if (a == b) return;
+    // Linking the larger index under the smaller keeps the labels produced at load time independent of thread timing
+    if (a < b) parent_[b] = a;
+    else parent_[a] = b;
+  }
+
+  void UnionRows(int first, int last) {
+    // Each thread only touches parent_ entries of its own band, so no locking is needed
+    for (int x = first; x < last; x++) {
+      for (int y = 0; y < cols_; y++) {
+        auto i = Index(x, y);
+        if (!free_[i]) continue;
+        if (y > 0 && free_[i - 1]) Union(i, i - 1);
+        if (x > first && free_[i - cols_]) Union(i, i - cols_);
+      }
+    }
+  }
+};
+
+template <typename Heuristic>
+vector<vector<TileState>> Search(vector<vector<TileState>>& grid, const Coordinate& start, const Coordinate& goal, const Heuristic& heuristic,
+                                 ConnectedComponents& components) {
+  // Different labels: the search could only end by exhausting the start's region, so skip it
+  if (!components.Connected(start, goal)) {
+    LOG_INFO("No path found.");
+    return grid;
+  }
+  return Search(grid, start, goal, heuristic);
+}
+
+vector<vector<TileState>> Search(vector<vector<TileState>>& grid, const Coordinate& start, const Coordinate& goal, ConnectedComponents& components) {
+  return Search(grid, start, goal, Distance, components);
+}
+
+#endif // COMPONENTS_H
@@ -0,0 +1,322 @@
+#ifndef COOPERATIVE_H
+#define COOPERATIVE_H
+
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <future>
+#include <chrono>
+#include <cstdint>
+
+#include "types.h"
+#include "planning.h"
+#include "grid_planning.h"
+#include "heuristics.h"
+#include "components.h"
+
+using std::vector;
+
+/*
+  Cooperative multi-agent planning: windowed hierarchical cooperative A* (WHCA*).
+
+  Independent PlanPath() calls let agents drive through each other. Here agents are planned one at a time in
+  space-time: every planned agent writes the tile it occupies at each time step into a shared reservation table, and
+  later agents treat those (tile, time) pairs as blocked, including head-on swaps through each other.
+
+    Windowed      - each agent only plans `window` steps ahead; after half a window everybody replans with a rotated
+                    priority order, so no agent is permanently last and the table stays small.
+    Hierarchical  - the space-time search is guided by the true shortest-path distance to the goal ignoring other
+                    agents (a DistanceField per goal from heuristics.h), which is far tighter than Manhattan distance.
+    Hashed table  - reservations live in an unordered_map keyed by (tile, time), so memory follows the number of
+                    agents times the window instead of the board size.
+
+  The distance fields are the exception: each costs one int per tile, so a Plan() call holds goals x board tiles of
+  them. They are built at the start of every call and freed at its end, which also keeps them in step with a board
+  that changed between calls.
+
+  Agents whose starts lie in different connected components can never meet, so each component is planned as an
+  independent group on its own thread with its own reservation table.
+
+  Like any prioritized planner WHCA* is not complete: an agent boxed in by higher-priority reservations waits in place.
+  CountConflicts() checks a finished plan.
+*/
+
+struct Agent {
+  int id; // e.g. Automobile::getID(); only reported back, the planner does not rely on ids being unique
+  Coordinate start;
+  Coordinate goal;
+};
+
+struct CooperativeStats {
+  size_t agents {0};
+  size_t groups {0};
+  size_t expanded {0};
+  double seconds {0.0};
+
+  double AgentsPerSecond() const { return seconds > 0.0 ? agents / seconds : 0.0; }
+};
+
+class ReservationTable {
+public:
+  static constexpr int kFree = -1;
+
+  explicit ReservationTable(int cols) : cols_{cols} {}
+
+  void Clear() { owners_.clear(); }
+
+  // Claims (c, t) for agent; returns false and leaves the table unchanged when another agent already holds it
+  bool Reserve(const Coordinate& c, int t, int agent) {
+    auto owner = owners_.emplace(Key(c, t), agent).first->second;
+    return owner == agent;
+  }
+
+  void Release(const Coordinate& c, int t, int agent) {
+    auto it = owners_.find(Key(c, t));
+    if (it != owners_.end() && it->second == agent) owners_.erase(it);
+  }
+
+  int Owner(const Coordinate& c, int t) const {
+    auto it = owners_.find(Key(c, t));
+    return it == owners_.end() ? kFree : it->second;
+  }
+
+  // Moving from `from` at time t to `to` at t + 1 must not enter a reserved tile or swap places with another agent
+  bool CanMove(const Coordinate& from, const Coordinate& to, int t, int agent) const {
+    auto owner = Owner(to, t + 1);
+    if (owner != kFree && owner != agent) return false;
+    auto swapper = Owner(to, t);
+    return swapper == kFree || swapper == agent || Owner(from, t + 1) != swapper;
+  }
+
+private:
+  int cols_;
+  std::unordered_map<uint64_t, int> owners_;
+
+  uint64_t Key(const Coordinate& c, int t) const {
+    return (static_cast<uint64_t>(t) << 40) | static_cast<uint64_t>(c.x * cols_ + c.y);
+  }
+};
+
+class CooperativePlanner {
+public:
+  CooperativePlanner(const vector<vector<TileState>>& board, int window)
+    : board_{board}, window_{std::max(2, window)}, cols_{board.empty() ? 0 : static_cast<int>(board[0].size())} {}
+
+  /*
+    Plans all agents and returns one PathResult per agent in input order. cells holds the agent's tile at every time
+    step (waits repeat the tile), cost is the time step from which the agent stays on its goal, and found is false for
+    agents that did not reach their goal within max_steps or whose fallback wait ran into another agent.
+  */
+  vector<PathResult> Plan(const vector<Agent>& agents, int max_steps, CooperativeStats* stats = nullptr) {
+    auto t0 = std::chrono::steady_clock::now();
+    vector<PathResult> results(agents.size());
+
+    // Group agents by the component of their start tile; a goal in another component is simply unreachable
+    ConnectedComponents components(board_);
+    std::map<int, vector<size_t>> groups;
+    for (size_t i = 0; i < agents.size(); i++) {
+      groups[components.Label(agents[i].start)].push_back(i);
+    }
+
+    // Distance fields are shared read-only by all groups, so build them all before starting any thread
+    Fields fields;
+    for (const auto& agent : agents) {
+      auto cell = agent.goal.x * cols_ + agent.goal.y;
+      if (fields.count(cell) == 0) fields.emplace(cell, DistanceField(board_, agent.goal));
+    }
+
+    vector<std::future<size_t>> futures;
+    for (const auto& group : groups) {
+      futures.emplace_back(std::async(std::launch::async, &CooperativePlanner::PlanGroup, this, std::cref(agents),
+                                      std::cref(group.second), std::cref(fields), max_steps, std::ref(results)));
+    }
+    size_t expanded = 0;
+    for (auto& future : futures) expanded += future.get();
+
+    if (stats) {
+      stats->agents = agents.size();
+      stats->groups = groups.size();
+      stats->expanded = expanded;
+      stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+    return results;
+  }
+
+private:
+  const vector<vector<TileState>>& board_;
+  int window_;
+  int cols_;
+
+  // Distance to each goal tile, keyed by x * cols + y
+  using Fields = std::unordered_map<int, DistanceField>;
+
+  struct SpaceTimeNode {
+    uint64_t key; // time * cells + tile
+    int g;
+    int f;
+  };
+
+  struct Visit {
+    int g;
+    uint64_t parent;
+  };
+
+  static bool CompareSpaceTime(const SpaceTimeNode& a, const SpaceTimeNode& b) {
+    return a.f > b.f || (a.f == b.f && a.g < b.g);
+  }
+
+  bool Passable(const Coordinate& c) const {
+    return c.x >= 0 && c.x < static_cast<int>(board_.size()) && c.y >= 0 && c.y < cols_ && board_[c.x][c.y] != TileState::Blocked;
+  }
+
+  size_t PlanGroup(const vector<Agent>& agents, const vector<size_t>& group, const Fields& fields, int max_steps,
+                   vector<PathResult>& results) {
+    // Reservations are owned by the agent's position in the group, so agents sharing an id still avoid each other
+    const auto advance = window_ / 2;
+    ReservationTable table(cols_);
+    vector<Coordinate> positions;
+    for (auto i : group) {
+      positions.push_back(agents[i].start);
+      results[i].cells.assign(1, agents[i].start);
+    }
+
+    vector<Coordinate> window_path;
+    vector<vector<Coordinate>> planned(group.size());
+    vector<bool> collided(group.size(), false);
+
+    for (int time = 0, round = 0; time < max_steps; time += advance, round++) {
+      bool all_home = true;
+      for (size_t k = 0; k < group.size(); k++) {
+        const auto& goal = agents[group[k]].goal;
+        all_home = all_home && positions[k].x == goal.x && positions[k].y == goal.y;
+      }
+      if (all_home) break;
+
+      table.Clear();
+      // Agents not planned yet hold their current tile for the whole window, so earlier agents route around them
+      for (size_t k = 0; k < group.size(); k++) {
+        for (int t = 0; t <= window_; t++) table.Reserve(positions[k], t, static_cast<int>(k));
+      }
+
+      for (size_t n = 0; n < group.size(); n++) {
+        auto k = (n + round) % group.size();
+        const auto& agent = agents[group[k]];
+        const auto owner = static_cast<int>(k);
+        for (int t = 1; t <= window_; t++) table.Release(positions[k], t, owner);
+        if (!SpaceTimeSearch(agent, owner, positions[k], fields, table, window_path, results[group[k]].expanded)) {
+          // Boxed in: wait in place for the whole window
+          window_path.assign(window_ + 1, positions[k]);
+        }
+        // Only the search checks its path against the table, so a step held by someone else means the plan collides
+        for (int t = 0; t <= window_; t++) {
+          if (!table.Reserve(window_path[t], t, owner)) collided[k] = true;
+        }
+        planned[k] = window_path;
+      }
+
+      for (size_t k = 0; k < group.size(); k++) {
+        auto& cells = results[group[k]].cells;
+        cells.insert(cells.end(), planned[k].begin() + 1, planned[k].begin() + advance + 1);
+        positions[k] = planned[k][advance];
+      }
+    }
+
+    size_t expanded = 0;
+    for (size_t k = 0; k < group.size(); k++) {
+      auto& result = results[group[k]];
+      const auto& goal = agents[group[k]].goal;
+      // Arrival time: the first step after which the agent never leaves its goal
+      auto arrival = static_cast<int>(result.cells.size());
+      while (arrival > 0 && result.cells[arrival - 1].x == goal.x && result.cells[arrival - 1].y == goal.y) arrival--;
+      result.found = !collided[k] && arrival < static_cast<int>(result.cells.size());
+      result.cost = arrival;
+      expanded += result.expanded;
+    }
+    return expanded;
+  }
+
+  bool SpaceTimeSearch(const Agent& agent, int owner, const Coordinate& from, const Fields& fields,
+                       const ReservationTable& table, vector<Coordinate>& path, int& expanded) const {
+    /*
+      A* over (tile, time) up to the end of the window. Every step costs 1 except waiting on the goal, which is free,
+      so an agent that has arrived prefers to stay unless it has to make way.
+    */
+    const auto& field = fields.at(agent.goal.x * cols_ + agent.goal.y);
+    if (field.At(from) == DistanceField::kUnreachable) return false;
+
+    const auto cells = static_cast<uint64_t>(board_.size()) * cols_;
+    const auto tile_of = [cols = cols_, cells](uint64_t key) {
+      auto tile = static_cast<int>(key % cells);
+      return Coordinate {tile / cols, tile % cols};
+    };
+    const auto key_of = [cols = cols_, cells](const Coordinate& c, int t) {
+      return static_cast<uint64_t>(t) * cells + static_cast<uint64_t>(c.x * cols + c.y);
+    };
+
+    std::unordered_map<uint64_t, Visit> visits;
+    vector<SpaceTimeNode> open;
+    auto start_key = key_of(from, 0);
+    visits[start_key] = Visit {0, start_key};
+    open.push_back(SpaceTimeNode {start_key, 0, field.At(from)});
+
+    while (!open.empty()) {
+      std::pop_heap(open.begin(), open.end(), CompareSpaceTime);
+      auto current = open.back();
+      open.pop_back();
+      if (current.g > visits[current.key].g) continue;
+      expanded++;
+
+      const auto t = static_cast<int>(current.key / cells);
+      const auto c = tile_of(current.key);
+      if (t == window_) {
+        path.assign(window_ + 1, from);
+        for (auto key = current.key; key != start_key; key = visits[key].parent) {
+          path[key / cells] = tile_of(key);
+        }
+        return true;
+      }
+
+      const bool at_goal = c.x == agent.goal.x && c.y == agent.goal.y;
+      // Wait in place, then the four moves from planning.h
+      for (int d = -1; d < 4; d++) {
+        auto next = d < 0 ? c : Coordinate {c.x + delta[d][0], c.y + delta[d][1]};
+        if (!Passable(next) || !table.CanMove(c, next, t, owner)) continue;
+        auto h = field.At(next);
+        if (h == DistanceField::kUnreachable) continue;
+
+        auto g = current.g + ((d < 0 && at_goal) ? 0 : 1);
+        auto key = key_of(next, t + 1);
+        auto it = visits.find(key);
+        if (it == visits.end() || g < it->second.g) {
+          visits[key] = Visit {g, current.key};
+          open.push_back(SpaceTimeNode {key, g, g + h});
+          std::push_heap(open.begin(), open.end(), CompareSpaceTime);
+        }
+      }
+    }
+    return false;
+  }
+};
+
+// Number of vertex (same tile, same time) and swap conflicts in a plan; agents stay on their last tile after their path ends
+int CountConflicts(const vector<PathResult>& paths) {
+  size_t horizon = 0;
+  for (const auto& path : paths) horizon = std::max(horizon, path.cells.size());
+  const auto at = [](const PathResult& path, size_t t) { return path.cells[std::min(t, path.cells.size() - 1)]; };
+  const auto same = [](const Coordinate& a, const Coordinate& b) { return a.x == b.x && a.y == b.y; };
+
+  int conflicts = 0;
+  for (size_t t = 0; t < horizon; t++) {
+    for (size_t a = 0; a < paths.size(); a++) {
+      for (size_t b = a + 1; b < paths.size(); b++) {
+        if (paths[a].cells.empty() || paths[b].cells.empty()) continue;
+        if (same(at(paths[a], t), at(paths[b], t))) conflicts++;
+        else if (t > 0 && same(at(paths[a], t), at(paths[b], t - 1)) && same(at(paths[a], t - 1), at(paths[b], t))) conflicts++;
+      }
+    }
+  }
+  return conflicts;
+}
+
+#endif // COOPERATIVE_H
@@ -0,0 +1,124 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+
+#include "types.h"
+#include "functions.h"
+#include "planning.h"
+#include "grid_planning.h"
+
+using std::vector;
+
+/*
+  Flow field: one reverse breadth-first search from a shared goal gives every reachable tile the direction of its next
+  step towards the goal, so each agent's path becomes a table walk instead of its own Search().
+
+  Directions are indices into delta from planning.h. The BFS expands one distance level at a time; a level's frontier is
+  split across threads with ParallelFor(), and tiles are claimed through an atomic bitset (one fetch_or per discovery)
+  so each tile is written by exactly one thread. Small frontiers run on the calling thread.
+*/
+class FlowField {
+public:
+  static constexpr int8_t kNoDirection = -1;
+
+  FlowField(const vector<vector<TileState>>& board, const Coordinate& goal)
+    : rows_{static_cast<int>(board.size())}, cols_{board.empty() ? 0 : static_cast<int>(board[0].size())}, goal_{goal} {
+    const auto cells = static_cast<size_t>(rows_) * cols_;
+    directions_.assign(cells, kNoDirection);
+    steps_.assign(cells, -1);
+    if (!InBounds(goal) || board[goal.x][goal.y] == TileState::Blocked) return;
+
+    const auto words = (cells + 63) / 64;
+    vector<uint64_t> passable(words, 0);
+    for (int x = 0; x < rows_; x++) {
+      for (int y = 0; y < cols_; y++) {
+        if (board[x][y] != TileState::Blocked) {
+          auto i = Index(x, y);
+          passable[i / 64] |= uint64_t{1} << (i % 64);
+        }
+      }
+    }
+    auto visited = std::make_unique<std::atomic<uint64_t>[]>(words);
+    for (size_t w = 0; w < words; w++) visited[w].store(0, std::memory_order_relaxed);
+
+    auto goal_cell = Index(goal.x, goal.y);
+    visited[goal_cell / 64].fetch_or(uint64_t{1} << (goal_cell % 64));
+    steps_[goal_cell] = 0;
+
+    vector<uint32_t> frontier {goal_cell};
+    vector<uint32_t> next;
+    std::mutex next_mutex;
+
+    for (int level = 1; !frontier.empty(); level++) {
+      next.clear();
+      ParallelFor(frontier.size(), [&](size_t begin, size_t end) {
+        vector<uint32_t> discovered;
+        for (auto f = begin; f < end; f++) {
+          const int x = frontier[f] / cols_;
+          const int y = frontier[f] % cols_;
+          for (int d = 0; d < 4; d++) {
+            const int nx = x + delta[d][0];
+            const int ny = y + delta[d][1];
+            if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) continue;
+            auto n = Index(nx, ny);
+            const auto bit = uint64_t{1} << (n % 64);
+            if (!(passable[n / 64] & bit)) continue;
+            if (visited[n / 64].fetch_or(bit, std::memory_order_relaxed) & bit) continue;
+            // From n the agent moves back towards the tile it was discovered from: the opposite direction
+            directions_[n] = static_cast<int8_t>((d + 2) % 4);
+            steps_[n] = level;
+            discovered.push_back(n);
+          }
+        }
+        std::lock_guard<std::mutex> lock(next_mutex);
+        next.insert(next.end(), discovered.begin(), discovered.end());
+      }, 2048);
+      frontier.swap(next);
+    }
+  }
+
+  Coordinate Goal() const noexcept { return goal_; }
+
+  // Index into delta of the next move from c, or kNoDirection at the goal and on tiles that cannot reach it
+  int8_t Direction(const Coordinate& c) const { return InBounds(c) ? directions_[Index(c.x, c.y)] : kNoDirection; }
+
+  // Number of moves from c to the goal, -1 when unreachable
+  int Steps(const Coordinate& c) const { return InBounds(c) ? steps_[Index(c.x, c.y)] : -1; }
+
+  bool Walk(const Coordinate& from, PathResult& result) const {
+    /*
+      Follows the directions from `from` to the goal. Writes into a caller-owned PathResult so agents walking in a loop
+      reuse one buffer.
+    */
+    result.cells.clear();
+    result.expanded = 0;
+    result.cost = Steps(from);
+    result.found = result.cost >= 0;
+    if (!result.found) return false;
+
+    auto c = from;
+    result.cells.push_back(c);
+    for (auto d = Direction(c); d != kNoDirection; d = Direction(c)) {
+      c = Coordinate {c.x + delta[d][0], c.y + delta[d][1]};
+      result.cells.push_back(c);
+    }
+    return true;
+  }
+
+private:
+  int rows_;
+  int cols_;
+  Coordinate goal_;
+  vector<int8_t> directions_;
+  vector<int> steps_;
+
+  bool InBounds(const Coordinate& c) const { return c.x >= 0 && c.x < rows_ && c.y >= 0 && c.y < cols_; }
+  uint32_t Index(int x, int y) const { return static_cast<uint32_t>(x * cols_ + y); }
+};
+
+#endif // FLOW_FIELD_H
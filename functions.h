@@ -27,8 +27,12 @@
 #include <type_traits>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <future>
+#include <thread>
 
 #include "types.h"
+#include "logger.h"
 
 using std::cout;
 using std::vector;
@@ -38,6 +42,24 @@ using std::ifstream;
 using std::istringstream;
 
 
+/*
+  Board files are comma separated tile values, one row per line:
+    0  - free tile with unit cost
+    1  - blocked tile
+    n  - (n >= 2) free tile whose terrain costs n to enter
+  Negative values are invalid and read as blocked tiles.
+
+  Before weighted terrain, every non-zero value meant blocked. Boards that only use 0 and 1 parse as before, but a
+  value of 2 or more now reads as a free tile with that cost.
+*/
+const int kBlockedValue = 1;
+
+// Terrain cost of a tile value, 0 for blocked; ParseLine() and ParseCostLine() both go through it so they agree
+int TileValueCost(int value) {
+  if (value == kBlockedValue || value < 0) return 0;
+  return value == 0 ? 1 : value;
+}
+
 vector<TileState> ParseLine(const string& line) {
   int n;
   char c;
@@ -46,17 +68,33 @@ vector<TileState> ParseLine(const string& line) {
 
   // The extraction operator will read until whitespace is reached or until the stream fails
   while (stream >> n >> c) {
-    if (n == 0) {
-      row.push_back(TileState::Free);
+    if (TileValueCost(n) == 0) {
+      row.push_back(TileState::Blocked);
     }
     else {
-      row.push_back(TileState::Blocked);
+      row.push_back(TileState::Free);
     }
   }
 
   return row;
 }
 
+vector<int> ParseCostLine(const string& line) {
+  /*
+    Same format as ParseLine() but keeps the terrain cost of each tile; 0 marks a blocked tile.
+  */
+  int n;
+  char c;
+  vector<int> row;
+  istringstream stream(line);
+
+  while (stream >> n >> c) {
+    row.push_back(TileValueCost(n));
+  }
+
+  return row;
+}
+
 vector<vector<TileState>> ReadBoardFile(const string& file_path) {
   /*
     Parse string lines from the board and store the ints in a vector using istringstream and push_back
@@ -65,7 +103,7 @@ vector<vector<TileState>> ReadBoardFile(const string& file_path) {
   vector<vector<TileState>> board;
 
   if (file) {
-    cout << "Successfully read " << file_path << " into an input file stream object.\n";
+    LOG_INFO("Successfully read {} into an input file stream object.", file_path);
     string line;
 
     while (getline(file, line)) {
@@ -74,12 +112,31 @@ vector<vector<TileState>> ReadBoardFile(const string& file_path) {
     }
   }
   else {
-    cout << "Path " << file_path << " does not exist or could not be found.\n";
+    LOG_WARNING("Path {} does not exist or could not be found.", file_path);
   }
 
   return board;
 }
 
+vector<vector<int>> ReadCostFile(const string& file_path) {
+  ifstream file(file_path);
+  vector<vector<int>> costs;
+
+  if (file) {
+    LOG_INFO("Successfully read {} into an input file stream object.", file_path);
+    string line;
+
+    while (getline(file, line)) {
+      costs.push_back(ParseCostLine(line));
+    }
+  }
+  else {
+    LOG_WARNING("Path {} does not exist or could not be found.", file_path);
+  }
+
+  return costs;
+}
+
 string TileToString(const TileState& tile) {
     switch (tile) {
         case TileState::Blocked: return "⛰️";
@@ -161,4 +218,23 @@ const T& Max(const T& a, const T& b) {
     return a > b ? a : b;
 }
 
+// Splits [0, n) into contiguous chunks and runs fn(begin, end) on each chunk with std::async
+template <typename Fn>
+void ParallelFor(size_t n, Fn fn, size_t min_chunk = 4096) {
+  auto threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  auto chunks = std::max<size_t>(1, std::min(threads, n / min_chunk));
+  if (chunks == 1) {
+    fn(size_t{0}, n);
+    return;
+  }
+
+  vector<std::future<void>> futures;
+  auto step = (n + chunks - 1) / chunks;
+  for (size_t begin = step; begin < n; begin += step) {
+    futures.emplace_back(std::async(std::launch::async, fn, begin, std::min(n, begin + step)));
+  }
+  fn(size_t{0}, std::min(n, step));
+  for (auto& future : futures) future.wait();
+}
+
 #endif // FUNCTIONS_H
\ No newline at end of file
@@ -0,0 +1,385 @@
+#ifndef GRID_PLANNING_H
+#define GRID_PLANNING_H
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#include "types.h"
+#include "planning.h"
+
+using std::vector;
+
+/*
+  A* over weighted and/or 8-connected grids.
+
+  Search() in planning.h is the teaching version: unit cost, 4 neighbours, and it uses the grid itself as the closed list.
+  PlanPath() generalizes it along two axes that are both chosen at compile time:
+
+    Connectivity - FourConnected or EightConnected<cut_corners>; provides the move deltas, the cost of straight and
+                   diagonal moves and the matching admissible heuristic (Manhattan or octile distance).
+    CostModel    - read-only view of the map returning the cost of entering a tile, 0 meaning impassable.
+                   UnitCost wraps a TileState board, TileCost wraps the per-tile weights from ReadCostFile().
+
+  With weighted tiles a cheaper route to a tile can be found after the tile was first reached, so unlike Search()
+  the planner keeps the best g per tile and only closes a tile when it is expanded. The board is never modified;
+  use MarkPath() to draw the result for DisplayBoard().
+
+  Searches that run repeatedly should pass a long-lived NodePool and PathResult; the overloads returning a
+  PathResult by value build a fresh pool on every call.
+
+  For FourConnected + UnitCost every step costs exactly 1, and the `if constexpr` branches below compile away the
+  per-tile weight multiply and the diagonal corner checks, leaving the same inner loop as Search().
+*/
+
+struct PathResult {
+  bool found {false};
+  int cost {0};
+  int expanded {0};
+  vector<Coordinate> cells; // start to goal inclusive; empty when no path was found
+};
+
+struct FourConnected {
+  static constexpr int kDirections = 4;
+  static constexpr int kStraightCost = 1;
+  static constexpr int kDiagonalCost = 1;
+  static constexpr bool kCutCorners = true;
+  static constexpr int kDelta[4][2] = {
+    {-1, 0},
+    {0, -1},
+    {1, 0},
+    {0, 1}
+  };
+
+  static int Heuristic(const Coordinate& a, const Coordinate& b) { return Distance(a, b); }
+};
+
+/*
+  Diagonal moves cost 14 against 10 for straight moves, the usual integer approximation of sqrt(2).
+  When cut_corners is false a diagonal move needs both tiles it squeezes past to be passable,
+  otherwise it is only refused when both of them are blocked.
+*/
+template <bool cut_corners = false>
+struct EightConnected {
+  static constexpr int kDirections = 8;
+  static constexpr int kStraightCost = 10;
+  static constexpr int kDiagonalCost = 14;
+  static constexpr bool kCutCorners = cut_corners;
+  // The first four entries are the straight moves in the same order as delta in planning.h
+  static constexpr int kDelta[8][2] = {
+    {-1, 0},
+    {0, -1},
+    {1, 0},
+    {0, 1},
+    {-1, -1},
+    {-1, 1},
+    {1, -1},
+    {1, 1}
+  };
+
+  static int Heuristic(const Coordinate& a, const Coordinate& b) {
+    // Octile distance: move diagonally while both axes differ, then straight
+    auto dx = std::abs(b.x - a.x);
+    auto dy = std::abs(b.y - a.y);
+    return kStraightCost * (dx + dy) + (kDiagonalCost - 2 * kStraightCost) * std::min(dx, dy);
+  }
+};
+
+class UnitCost {
+public:
+  static constexpr bool kUniform = true;
+
+  explicit UnitCost(const vector<vector<TileState>>& grid) : grid_{grid} {}
+
+  int Rows() const { return static_cast<int>(grid_.size()); }
+  int Cols() const { return grid_.empty() ? 0 : static_cast<int>(grid_[0].size()); }
+
+  // Any tile that is not Blocked is passable, so boards already marked by Search() still plan correctly
+  int operator()(int x, int y) const { return grid_[x][y] == TileState::Blocked ? 0 : 1; }
+
+private:
+  const vector<vector<TileState>>& grid_;
+};
+
+class TileCost {
+public:
+  static constexpr bool kUniform = false;
+
+  explicit TileCost(const vector<vector<int>>& costs) : costs_{costs} {}
+
+  int Rows() const { return static_cast<int>(costs_.size()); }
+  int Cols() const { return costs_.empty() ? 0 : static_cast<int>(costs_[0].size()); }
+
+  int operator()(int x, int y) const { return costs_[x][y]; }
+
+private:
+  const vector<vector<int>>& costs_;
+};
+
+template <typename CostModel>
+bool Passable(const CostModel& cost, int x, int y) {
+  return x >= 0 && x < cost.Rows() && y >= 0 && y < cost.Cols() && cost(x, y) > 0;
+}
+
+/*
+  Open list entry for PlanPath(). The tile is a packed 32-bit CellIndex rather than a Coordinate and f = g + h
+  is stored instead of h, so a node is 12 bytes and heap comparisons read a single field.
+*/
+struct PackedNode {
+  uint32_t cell;
+  int g;
+  int f;
+};
+
+static_assert(sizeof(PackedNode) == 12, "PackedNode should stay three 32-bit words");
+
+bool ComparePacked(const PackedNode& a, const PackedNode& b) {
+  // Min-heap on f; among equal f prefer the deeper node, which is closer to the goal
+  return a.f > b.f || (a.f == b.f && a.g < b.g);
+}
+
+/*
+  Numbers the tiles of a rows x cols grid block by block (kBlockSize x kBlockSize tiles per block, blocks row by row)
+  rather than row by row. A run of kBlockSize^2 consecutive indices is then a square area, which is what lets
+  NodePool allocate its state in pages that follow the region a search explores. Edge blocks are padded, so Count()
+  can exceed rows * cols.
+*/
+class CellIndex {
+public:
+  static constexpr uint32_t kBlockBits = 4;
+  static constexpr uint32_t kBlockSize = 1u << kBlockBits;
+
+  CellIndex(int rows, int cols)
+    : block_rows_{(static_cast<uint32_t>(rows) + kBlockSize - 1) >> kBlockBits},
+      block_cols_{(static_cast<uint32_t>(cols) + kBlockSize - 1) >> kBlockBits} {}
+
+  // Cell ids are uint32_t and NodePool stores parents as int, so a grid is only indexable up to INT_MAX cells
+  static constexpr size_t kMaxCount = static_cast<size_t>(INT_MAX);
+
+  size_t Count() const { return static_cast<size_t>(block_rows_) * block_cols_ << (2 * kBlockBits); }
+
+  // False when ids would wrap and two distant tiles would share one
+  bool Fits() const { return Count() <= kMaxCount; }
+
+  uint32_t operator()(int x, int y) const {
+    const auto block = (static_cast<uint32_t>(x) >> kBlockBits) * block_cols_ + (static_cast<uint32_t>(y) >> kBlockBits);
+    return block << (2 * kBlockBits) | (static_cast<uint32_t>(x) & (kBlockSize - 1)) << kBlockBits |
+           (static_cast<uint32_t>(y) & (kBlockSize - 1));
+  }
+
+  Coordinate At(uint32_t cell) const {
+    const auto block = cell >> (2 * kBlockBits);
+    return Coordinate {static_cast<int>((block / block_cols_) << kBlockBits | ((cell >> kBlockBits) & (kBlockSize - 1))),
+                       static_cast<int>((block % block_cols_) << kBlockBits | (cell & (kBlockSize - 1)))};
+  }
+
+private:
+  uint32_t block_rows_;
+  uint32_t block_cols_;
+};
+
+/*
+  Per-search storage for PlanPath(), meant to be kept alive and reused across searches.
+
+  Per-tile state (stamp, best g, parent: 12 bytes) lives in pages of kPageCells consecutive cell indices, one
+  CellIndex block each, that are only allocated when the search first reaches one of their tiles, so memory follows
+  the area a search explores rather than the size of the map. That matters for TiledBoard maps that do not fit in memory: a dense 12 bytes per tile
+  would be twelve times the map itself. Only the page directory (one pointer per page) is sized for the whole grid.
+
+  Pages are never freed and the open list keeps its capacity, so once a pool has explored an area, later searches
+  over it perform no heap allocations. Instead of clearing pages between searches each tile carries a generation
+  stamp: a tile whose stamp is older than the current search is unvisited.
+*/
+class NodePool {
+public:
+  static constexpr uint32_t kPageBits = 2 * CellIndex::kBlockBits;
+  static constexpr uint32_t kPageCells = 1u << kPageBits;
+
+  NodePool() = default;
+  explicit NodePool(size_t cells) { Reserve(cells); }
+
+  void Reserve(size_t cells) {
+    auto pages = (cells + kPageCells - 1) / kPageCells;
+    if (pages > pages_.size()) pages_.resize(pages);
+  }
+
+  // Prepares the pool for a new search over cells 0 .. cells - 1, normally CellIndex::Count()
+  void Begin(size_t cells) {
+    Reserve(cells);
+    open_.clear();
+    // Each search uses two stamp values: open_mark_ for reached tiles and open_mark_ + 1 for expanded (closed) ones
+    if (open_mark_ >= UINT32_MAX - 2) {
+      for (auto& page : pages_) {
+        if (page) std::fill(std::begin(page->stamp), std::end(page->stamp), 0);
+      }
+      open_mark_ = 0;
+    }
+    open_mark_ += 2;
+  }
+
+  bool Reached(uint32_t cell) const {
+    const auto* page = pages_[cell >> kPageBits].get();
+    return page && page->stamp[cell & (kPageCells - 1)] >= open_mark_;
+  }
+  bool Closed(uint32_t cell) const {
+    const auto* page = pages_[cell >> kPageBits].get();
+    return page && page->stamp[cell & (kPageCells - 1)] == open_mark_ + 1;
+  }
+  int BestG(uint32_t cell) const { return Reached(cell) ? pages_[cell >> kPageBits]->best_g[cell & (kPageCells - 1)] : INT_MAX; }
+  // Only valid for tiles reached by the current search
+  int Parent(uint32_t cell) const { return pages_[cell >> kPageBits]->parent[cell & (kPageCells - 1)]; }
+
+  void Open(uint32_t cell, int g, int parent) {
+    auto& page = pages_[cell >> kPageBits];
+    // Value-initialized, so every stamp starts at 0 (unvisited)
+    if (!page) page = std::make_unique<Page>();
+    const auto i = cell & (kPageCells - 1);
+    page->stamp[i] = open_mark_;
+    page->best_g[i] = g;
+    page->parent[i] = parent;
+  }
+
+  void Close(uint32_t cell) { pages_[cell >> kPageBits]->stamp[cell & (kPageCells - 1)] = open_mark_ + 1; }
+
+  void Push(const PackedNode& node) {
+    open_.push_back(node);
+    std::push_heap(open_.begin(), open_.end(), ComparePacked);
+  }
+
+  PackedNode Pop() {
+    std::pop_heap(open_.begin(), open_.end(), ComparePacked);
+    auto node = open_.back();
+    open_.pop_back();
+    return node;
+  }
+
+  bool Empty() const { return open_.empty(); }
+  size_t OpenSize() const { return open_.size(); }
+  const PackedNode& Top() const { return open_.front(); }
+
+  // Heap memory held by the pool: allocated pages, the page directory and the open list's capacity
+  size_t ResidentBytes() const {
+    auto pages = std::count_if(pages_.begin(), pages_.end(), [](const std::unique_ptr<Page>& page) { return page != nullptr; });
+    return static_cast<size_t>(pages) * sizeof(Page) + pages_.capacity() * sizeof(std::unique_ptr<Page>) +
+           open_.capacity() * sizeof(PackedNode);
+  }
+
+private:
+  struct Page {
+    uint32_t stamp[kPageCells];
+    int best_g[kPageCells];
+    int parent[kPageCells];
+  };
+
+  vector<PackedNode> open_;
+  vector<std::unique_ptr<Page>> pages_;
+  uint32_t open_mark_ {0};
+};
+
+template <typename Connectivity, typename CostModel, typename Heuristic>
+bool PlanPath(const CostModel& cost, const Coordinate& start, const Coordinate& goal, const Heuristic& heuristic,
+              NodePool& pool, PathResult& result) {
+  /*
+    The heuristic has the same signature as the one passed to Search(). It must not overestimate in the
+    connectivity's cost units; every tile costs at least 1, so Connectivity::Heuristic is admissible.
+    The path is written into result.cells, whose capacity is reused from the previous call.
+  */
+  result.found = false;
+  result.cost = 0;
+  result.expanded = 0;
+  result.cells.clear();
+  const CellIndex index(cost.Rows(), cost.Cols());
+  if (!index.Fits()) {
+    LOG_WARNING("A {}x{} board has more tiles than the planner can index.", cost.Rows(), cost.Cols());
+    return false;
+  }
+  if (!Passable(cost, start.x, start.y) || !Passable(cost, goal.x, goal.y)) return false;
+
+  pool.Begin(index.Count());
+  const auto start_cell = index(start.x, start.y);
+  const auto goal_cell = index(goal.x, goal.y);
+  pool.Open(start_cell, 0, -1);
+  pool.Push(PackedNode {start_cell, 0, heuristic(start, goal)});
+
+  while (!pool.Empty()) {
+    auto current = pool.Pop();
+    // Stale entry: the tile was already expanded through a cheaper node pushed later
+    if (pool.Closed(current.cell) || current.g > pool.BestG(current.cell)) continue;
+    pool.Close(current.cell);
+    result.expanded++;
+
+    if (current.cell == goal_cell) {
+      result.found = true;
+      result.cost = current.g;
+      for (auto i = static_cast<int>(current.cell); i != -1; i = pool.Parent(i)) {
+        result.cells.push_back(index.At(i));
+      }
+      std::reverse(result.cells.begin(), result.cells.end());
+      return true;
+    }
+
+    const auto here = index.At(current.cell);
+    const int x = here.x;
+    const int y = here.y;
+    for (int direction = 0; direction < Connectivity::kDirections; direction++) {
+      const auto dx = Connectivity::kDelta[direction][0];
+      const auto dy = Connectivity::kDelta[direction][1];
+      if (!Passable(cost, x + dx, y + dy)) continue;
+
+      auto step = Connectivity::kStraightCost;
+      if constexpr (Connectivity::kDirections == 8) {
+        if (dx != 0 && dy != 0) {
+          auto side_a = Passable(cost, x + dx, y);
+          auto side_b = Passable(cost, x, y + dy);
+          if (Connectivity::kCutCorners ? !(side_a || side_b) : !(side_a && side_b)) continue;
+          step = Connectivity::kDiagonalCost;
+        }
+      }
+      if constexpr (!CostModel::kUniform) {
+        step *= cost(x + dx, y + dy);
+      }
+
+      auto g = current.g + step;
+      auto neighbor_cell = index(x + dx, y + dy);
+      if (g < pool.BestG(neighbor_cell)) {
+        pool.Open(neighbor_cell, g, static_cast<int>(current.cell));
+        pool.Push(PackedNode {neighbor_cell, g, g + heuristic(Coordinate {x + dx, y + dy}, goal)});
+      }
+    }
+  }
+
+  return false;
+}
+
+template <typename Connectivity, typename CostModel, typename Heuristic>
+PathResult PlanPath(const CostModel& cost, const Coordinate& start, const Coordinate& goal, const Heuristic& heuristic) {
+  NodePool pool;
+  PathResult result;
+  PlanPath<Connectivity>(cost, start, goal, heuristic, pool, result);
+  return result;
+}
+
+template <typename Connectivity = FourConnected, typename CostModel>
+PathResult PlanPath(const CostModel& cost, const Coordinate& start, const Coordinate& goal) {
+  return PlanPath<Connectivity>(cost, start, goal, Connectivity::Heuristic);
+}
+
+template <typename Connectivity = FourConnected, typename CostModel>
+bool PlanPath(const CostModel& cost, const Coordinate& start, const Coordinate& goal, NodePool& pool, PathResult& result) {
+  return PlanPath<Connectivity>(cost, start, goal, Connectivity::Heuristic, pool, result);
+}
+
+void MarkPath(vector<vector<TileState>>& grid, const PathResult& result) {
+  if (!result.found) return;
+  for (const auto& c : result.cells) {
+    grid[c.x][c.y] = TileState::Path;
+  }
+  grid[result.cells.front().x][result.cells.front().y] = TileState::Start;
+  grid[result.cells.back().x][result.cells.back().y] = TileState::Finish;
+}
+
+#endif // GRID_PLANNING_H
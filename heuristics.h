@@ -0,0 +1,235 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+#include "types.h"
+#include "planning.h"
+#include "logger.h"
+
+using std::vector;
+using std::string;
+
+/*
+  Precomputed heuristics for Search().
+
+  DistanceField      - exact distance from every tile to one source tile, computed by a reverse breadth-first search.
+                       Used as the heuristic for a fixed goal (e.g. a depot) it is perfect: A* only expands tiles on a shortest path.
+  LandmarkHeuristic  - ALT ("A*, Landmarks, Triangle inequality"). Distance fields from a few landmark tiles give the lower bound
+                       |d(L, goal) - d(L, cell)| for any goal, so one small table speeds up queries to arbitrary goals.
+
+  Both are callables with the same signature as Distance() and plug straight into Search(grid, start, goal, heuristic).
+  Tables are built from a freshly loaded board (before Search() marks tiles as Closed/Path) and can be saved to disk
+  with WriteHeuristicFile() and loaded back with ReadHeuristicFile().
+*/
+
+class DistanceField {
+public:
+  static constexpr int kUnreachable = -1;
+
+  DistanceField() = default;
+
+  DistanceField(const vector<vector<TileState>>& board, const Coordinate& source)
+    : rows_{static_cast<int>(board.size())}, cols_{board.empty() ? 0 : static_cast<int>(board[0].size())}, source_{source} {
+    distances_.assign(static_cast<size_t>(rows_) * cols_, kUnreachable);
+    if (!InBounds(source) || board[source.x][source.y] == TileState::Blocked) return;
+
+    // Breadth-first search: every move costs 1, so tiles are discovered in order of distance
+    vector<Coordinate> frontier {source};
+    vector<Coordinate> next;
+    distances_[Index(source)] = 0;
+
+    for (int distance = 1; !frontier.empty(); distance++) {
+      next.clear();
+      for (const auto& c : frontier) {
+        for (auto& d : delta) {
+          auto neighbor = Coordinate {c.x + d[0], c.y + d[1]};
+          if (InBounds(neighbor) && board[neighbor.x][neighbor.y] != TileState::Blocked && distances_[Index(neighbor)] == kUnreachable) {
+            distances_[Index(neighbor)] = distance;
+            next.push_back(neighbor);
+          }
+        }
+      }
+      frontier.swap(next);
+    }
+  }
+
+  int Rows() const noexcept { return rows_; }
+  int Cols() const noexcept { return cols_; }
+  Coordinate Source() const noexcept { return source_; }
+
+  int At(const Coordinate& c) const {
+    return InBounds(c) ? distances_[Index(c)] : kUnreachable;
+  }
+
+  int operator()(const Coordinate& c, const Coordinate& goal) const {
+    /*
+      Only exact when the query goal is this field's source; for any other goal fall back to Manhattan distance.
+      Tiles that cannot reach the goal get a large value so Search() leaves them at the back of the open list.
+    */
+    if (goal.x != source_.x || goal.y != source_.y) return Distance(c, goal);
+    auto d = At(c);
+    return d == kUnreachable ? rows_ * cols_ : d;
+  }
+
+private:
+  int rows_ {0};
+  int cols_ {0};
+  Coordinate source_ {0, 0};
+  vector<int> distances_;
+
+  bool InBounds(const Coordinate& c) const { return c.x >= 0 && c.x < rows_ && c.y >= 0 && c.y < cols_; }
+  size_t Index(const Coordinate& c) const { return static_cast<size_t>(c.x) * cols_ + c.y; }
+
+  friend bool WriteHeuristicFile(const string& file_path, const vector<DistanceField>& fields);
+  friend vector<DistanceField> ReadHeuristicFile(const string& file_path);
+};
+
+class LandmarkHeuristic {
+public:
+  LandmarkHeuristic() = default;
+  explicit LandmarkHeuristic(vector<DistanceField> landmarks) : landmarks_{std::move(landmarks)} {}
+
+  LandmarkHeuristic(const vector<vector<TileState>>& board, int count) {
+    /*
+      Farthest-point selection: each new landmark is the free tile farthest from all landmarks picked so far,
+      which spreads them around the edges of the map where they give the tightest bounds.
+    */
+    Coordinate first {-1, -1};
+    for (int x = 0; x < static_cast<int>(board.size()) && first.x < 0; x++) {
+      for (int y = 0; y < static_cast<int>(board[x].size()); y++) {
+        if (board[x][y] != TileState::Blocked) {
+          first = Coordinate {x, y};
+          break;
+        }
+      }
+    }
+    if (first.x < 0) return;
+
+    DistanceField seed(board, first);
+    vector<int> closest(static_cast<size_t>(seed.Rows()) * seed.Cols(), DistanceField::kUnreachable);
+    auto update = [&](const DistanceField& field) {
+      for (int x = 0; x < field.Rows(); x++) {
+        for (int y = 0; y < field.Cols(); y++) {
+          auto d = field.At(Coordinate {x, y});
+          auto& best = closest[static_cast<size_t>(x) * field.Cols() + y];
+          if (d != DistanceField::kUnreachable && (best == DistanceField::kUnreachable || d < best)) best = d;
+        }
+      }
+    };
+    update(seed);
+
+    for (int i = 0; i < count; i++) {
+      auto farthest = std::max_element(closest.begin(), closest.end()) - closest.begin();
+      auto landmark = Coordinate {static_cast<int>(farthest / seed.Cols()), static_cast<int>(farthest % seed.Cols())};
+      landmarks_.emplace_back(board, landmark);
+      update(landmarks_.back());
+    }
+  }
+
+  const vector<DistanceField>& Landmarks() const noexcept { return landmarks_; }
+
+  int operator()(const Coordinate& c, const Coordinate& goal) const {
+    // Manhattan distance is always a valid lower bound, the landmarks can only tighten it
+    auto h = Distance(c, goal);
+    for (const auto& landmark : landmarks_) {
+      auto to_cell = landmark.At(c);
+      auto to_goal = landmark.At(goal);
+      if (to_cell != DistanceField::kUnreachable && to_goal != DistanceField::kUnreachable) {
+        h = std::max(h, std::abs(to_goal - to_cell));
+      }
+    }
+    return h;
+  }
+
+private:
+  vector<DistanceField> landmarks_;
+};
+
+/*
+  Binary table format:
+    "HEUR" magic, uint32 field count, then per field: int32 rows, cols, source x, source y followed by rows * cols int32 distances.
+  The file is written in host byte order; it is a cache of a board, not an interchange format.
+*/
+const char kHeuristicMagic[4] = {'H', 'E', 'U', 'R'};
+
+bool WriteHeuristicFile(const string& file_path, const vector<DistanceField>& fields) {
+  std::ofstream file(file_path, std::ios::binary);
+  if (!file) {
+    LOG_WARNING("Path {} could not be opened for writing.", file_path);
+    return false;
+  }
+
+  auto write_int = [&file](int32_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+  file.write(kHeuristicMagic, sizeof(kHeuristicMagic));
+  write_int(static_cast<int32_t>(fields.size()));
+  for (const auto& field : fields) {
+    write_int(field.rows_);
+    write_int(field.cols_);
+    write_int(field.source_.x);
+    write_int(field.source_.y);
+    file.write(reinterpret_cast<const char*>(field.distances_.data()), field.distances_.size() * sizeof(int));
+  }
+  return static_cast<bool>(file);
+}
+
+vector<DistanceField> ReadHeuristicFile(const string& file_path) {
+  /*
+    Mirrors ReadBoardFile(): an unreadable or malformed file yields an empty vector, which makes
+    LandmarkHeuristic fall back to plain Manhattan distance.
+  */
+  std::ifstream file(file_path, std::ios::binary);
+  vector<DistanceField> fields;
+
+  if (!file) {
+    LOG_WARNING("Path {} does not exist or could not be found.", file_path);
+    return fields;
+  }
+
+  auto read_int = [&file]() {
+    int32_t value = 0;
+    file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  };
+
+  // Sizes in the header are checked against what is left of the file before anything is allocated from them
+  file.seekg(0, std::ios::end);
+  const auto file_size = static_cast<uint64_t>(file.tellg());
+  file.seekg(0, std::ios::beg);
+  auto remaining = [&file, file_size]() { return file_size - static_cast<uint64_t>(file.tellg()); };
+
+  char magic[4] = {};
+  file.read(magic, sizeof(magic));
+  if (!std::equal(magic, magic + 4, kHeuristicMagic)) {
+    LOG_WARNING("{} is not a heuristic table file.", file_path);
+    return fields;
+  }
+
+  auto count = read_int();
+  for (int32_t i = 0; i < count && file; i++) {
+    DistanceField field;
+    field.rows_ = read_int();
+    field.cols_ = read_int();
+    field.source_ = Coordinate {read_int(), read_int()};
+    if (!file || field.rows_ < 0 || field.cols_ < 0) break;
+    const auto cells = static_cast<uint64_t>(field.rows_) * static_cast<uint64_t>(field.cols_);
+    if (cells > remaining() / sizeof(int)) break;
+    field.distances_.resize(static_cast<size_t>(cells));
+    file.read(reinterpret_cast<char*>(field.distances_.data()), field.distances_.size() * sizeof(int));
+    if (file) fields.push_back(std::move(field));
+  }
+
+  if (static_cast<int32_t>(fields.size()) != count) {
+    LOG_WARNING("{} is truncated or corrupt.", file_path);
+    fields.clear();
+  }
+  return fields;
+}
+
+#endif // HEURISTICS_H
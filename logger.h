@@ -0,0 +1,363 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+
+/*
+  Asynchronous logger that keeps std::cout out of hot paths.
+
+  Writing to std::cout from many threads serializes them on the stream's lock, and std::endl flushes on every line.
+  Instead, LOG_INFO(format, args...) copies the format pointer and up to kMaxLogArgs arguments into a ring buffer
+  owned by the calling thread. Nothing is formatted on that thread: a background thread drains every ring,
+  substitutes the arguments for the "{}" placeholders, prefixes the level, and writes the lines in one batch.
+
+  - Each ring has one producer (its thread) and one consumer (the flusher), so it only needs two atomic indices.
+  - The flusher does not poll forever: after an empty drain it backs off (1 ms doubling to kLogMaxBackoffMs) and then
+    sleeps on a condition variable until a thread logs again. A producer only touches the condition variable when its
+    ring goes from empty to non-empty while the flusher sleeps, or when its ring is half full.
+  - When a ring is full the producer yields until the flusher makes room; messages are never dropped.
+  - Levels below LOG_LEVEL are removed at compile time: the macros expand to a discarded `if constexpr` branch,
+    so not even the arguments are evaluated. Build with -DLOG_LEVEL=0 to enable LOG_DEBUG.
+  - The format must be a string literal. String arguments are copied into kLogTextBytes of per-record storage shared
+    by all arguments of the line; anything that does not fit is cut and marked with "...".
+  - Lines from one thread keep their order; lines from different threads are interleaved in drain order. Code that
+    mixes LOG_* with direct std::cout writes should call Logger::Instance().Flush() before writing.
+
+  The win is latency on the calling thread while bursts fit in the ring (kLogRingSize lines per thread). Sustained
+  logging faster than the flusher can format is bounded by the flusher, and on a single core that is no faster than
+  formatting in place.
+*/
+
+enum class LogLevel { Debug, Info, Warning, Error, Off };
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 1
+#endif
+
+constexpr LogLevel kCompiledLogLevel = static_cast<LogLevel>(LOG_LEVEL);
+constexpr int kMaxLogArgs = 4;
+constexpr size_t kLogTextBytes = 256;
+constexpr size_t kLogRingSize = 512;
+constexpr int kLogMaxBackoffMs = 64;
+
+struct LogArg {
+  enum class Kind : uint8_t { Int, UInt, Double, Pointer, Text };
+
+  Kind kind;
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void* p;
+    // Slice of LogRecord::text
+    struct {
+      uint16_t offset;
+      uint16_t length;
+    } text;
+  };
+};
+
+struct LogRecord {
+  const char* format;
+  LogLevel level;
+  uint8_t count;
+  uint16_t text_used;
+  LogArg args[kMaxLogArgs];
+  char text[kLogTextBytes];
+};
+
+void AddLogArg(LogRecord& record, const char* value) {
+  auto& arg = record.args[record.count++];
+  arg.kind = LogArg::Kind::Text;
+  const auto length = std::strlen(value);
+  const auto space = kLogTextBytes - record.text_used;
+  auto copied = std::min(length, space);
+  char* out = record.text + record.text_used;
+  std::memcpy(out, value, copied);
+  // Too long for what is left of the record: keep the start and mark the cut
+  if (copied < length && copied >= 3) std::memcpy(out + copied - 3, "...", 3);
+  arg.text.offset = record.text_used;
+  arg.text.length = static_cast<uint16_t>(copied);
+  record.text_used += static_cast<uint16_t>(copied);
+}
+
+// Without this overload a char* would match the template exactly and be logged as a pointer
+void AddLogArg(LogRecord& record, char* value) { AddLogArg(record, static_cast<const char*>(value)); }
+
+void AddLogArg(LogRecord& record, const std::string& value) { AddLogArg(record, value.c_str()); }
+
+template <typename T>
+void AddLogArg(LogRecord& record, const T& value) {
+  auto& arg = record.args[record.count++];
+  if constexpr (std::is_floating_point<T>::value) {
+    arg.kind = LogArg::Kind::Double;
+    arg.d = value;
+  }
+  else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+    arg.kind = LogArg::Kind::Int;
+    arg.i = value;
+  }
+  else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+    arg.kind = LogArg::Kind::UInt;
+    arg.u = static_cast<uint64_t>(value);
+  }
+  else {
+    static_assert(std::is_pointer<T>::value, "Log arguments must be numbers, strings, enums or pointers.");
+    arg.kind = LogArg::Kind::Pointer;
+    arg.p = static_cast<const void*>(value);
+  }
+}
+
+class LogRing {
+public:
+  // Returns the number of records in the ring after the push, or 0 when it is full
+  size_t TryPush(const LogRecord& record) {
+    auto head = head_.load(std::memory_order_relaxed);
+    auto used = head - tail_.load(std::memory_order_acquire);
+    if (used == kLogRingSize) return 0;
+    records_[head % kLogRingSize] = record;
+    head_.store(head + 1, std::memory_order_release);
+    return used + 1;
+  }
+
+  template <typename Fn>
+  size_t Drain(Fn fn) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto head = head_.load(std::memory_order_acquire);
+    for (auto i = tail; i != head; i++) fn(records_[i % kLogRingSize]);
+    tail_.store(head, std::memory_order_release);
+    return head - tail;
+  }
+
+  bool Empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+  // Set when the owning thread exits; the flusher frees the ring once it is drained
+  std::atomic<bool> retired {false};
+
+private:
+  LogRecord records_[kLogRingSize];
+  // Separate cache lines so producer and consumer do not invalidate each other's index
+  alignas(64) std::atomic<size_t> head_ {0};
+  alignas(64) std::atomic<size_t> tail_ {0};
+};
+
+class Logger {
+public:
+  static Logger& Instance() {
+    static Logger logger;
+    return logger;
+  }
+
+  template <typename... Args>
+  void Log(LogLevel level, const char* format, const Args&... args) {
+    static_assert(sizeof...(Args) <= kMaxLogArgs, "Too many log arguments.");
+    LogRecord record;
+    record.format = format;
+    record.level = level;
+    record.count = 0;
+    record.text_used = 0;
+    (AddLogArg(record, args), ...);
+
+    auto& ring = LocalRing();
+    size_t used;
+    while ((used = ring.TryPush(record)) == 0) {
+      Wake();
+      std::this_thread::yield();
+    }
+    if (used == kLogRingSize / 2) {
+      Wake();
+    }
+    else if (used == 1) {
+      // Pairs with the fence in the flusher: either it sees this record before sleeping or this thread sees it asleep
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (sleeping_.load(std::memory_order_relaxed)) Wake();
+    }
+  }
+
+  // Blocks until everything logged before the call has been written
+  void Flush() {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    DrainLocked();
+  }
+
+  // Redirects output; the stream must outlive the logger or the next SetOutput() call
+  void SetOutput(std::ostream& output) {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    DrainLocked();
+    output_ = &output;
+  }
+
+  ~Logger() {
+    running_ = false;
+    Wake();
+    flusher_.join();
+    Flush();
+  }
+
+private:
+  std::mutex registry_mutex_;
+  std::vector<std::shared_ptr<LogRing>> rings_;
+  std::mutex drain_mutex_;
+  std::string buffer_;
+  std::ostream* output_ {&std::cout};
+  std::atomic<bool> running_ {true};
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;
+  bool wake_ {false};
+  std::atomic<bool> sleeping_ {false};
+  std::thread flusher_;
+
+  Logger() {
+    buffer_.reserve(1 << 16);
+    flusher_ = std::thread([this] { FlushLoop(); });
+  }
+
+  void Wake() {
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      wake_ = true;
+    }
+    wake_cv_.notify_one();
+  }
+
+  void FlushLoop() {
+    int backoff_ms = 1;
+    while (running_) {
+      size_t drained;
+      {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        drained = DrainLocked();
+      }
+      if (drained > 0) {
+        backoff_ms = 1;
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      if (backoff_ms <= kLogMaxBackoffMs) {
+        // Recently busy: check again soon, later and later, unless a producer asks for a drain
+        wake_cv_.wait_for(lock, std::chrono::milliseconds(backoff_ms), [this] { return wake_ || !running_; });
+        backoff_ms *= 2;
+      }
+      else {
+        // Idle: sleep until a producer logs into an empty ring. Re-check after announcing it to close the race.
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!AnyPending()) wake_cv_.wait(lock, [this] { return wake_ || !running_; });
+        sleeping_.store(false, std::memory_order_relaxed);
+        backoff_ms = 1;
+      }
+      wake_ = false;
+    }
+  }
+
+  bool AnyPending() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return std::any_of(rings_.begin(), rings_.end(), [](const std::shared_ptr<LogRing>& ring) { return !ring->Empty(); });
+  }
+
+  struct RingHolder {
+    std::shared_ptr<LogRing> ring;
+    ~RingHolder() {
+      if (ring) ring->retired = true;
+    }
+  };
+
+  LogRing& LocalRing() {
+    thread_local RingHolder holder;
+    if (!holder.ring) {
+      holder.ring = std::make_shared<LogRing>();
+      std::lock_guard<std::mutex> lock(registry_mutex_);
+      rings_.push_back(holder.ring);
+    }
+    return *holder.ring;
+  }
+
+  size_t DrainLocked() {
+    /*
+      The registry lock is held while draining; producers only take it once, when their thread logs for the first time.
+      Nothing here allocates once buffer_ has grown to its working size.
+    */
+    size_t drained = 0;
+    buffer_.clear();
+    {
+      std::lock_guard<std::mutex> lock(registry_mutex_);
+      for (auto it = rings_.begin(); it != rings_.end();) {
+        drained += (*it)->Drain([this](const LogRecord& record) { Format(record); });
+        // Forget rings whose thread has exited and whose records have all been written
+        if ((*it)->retired && (*it)->Empty()) it = rings_.erase(it);
+        else ++it;
+      }
+    }
+    if (!buffer_.empty()) {
+      output_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+      output_->flush();
+    }
+    return drained;
+  }
+
+  static const char* LevelTag(LogLevel level) {
+    switch (level) {
+      case LogLevel::Debug: return "[DEBUG] ";
+      case LogLevel::Info: return "[INFO] ";
+      case LogLevel::Warning: return "[WARNING] ";
+      case LogLevel::Error: return "[ERROR] ";
+      default: return "";
+    }
+  }
+
+  void Format(const LogRecord& record) {
+    buffer_.append(LevelTag(record.level));
+    int next = 0;
+    for (const char* c = record.format; *c; c++) {
+      if (c[0] == '{' && c[1] == '}' && next < record.count) {
+        AppendArg(record, record.args[next++]);
+        c++;
+      }
+      else {
+        buffer_.push_back(*c);
+      }
+    }
+    buffer_.push_back('\n');
+  }
+
+  void AppendArg(const LogRecord& record, const LogArg& arg) {
+    char scratch[32];
+    int n = 0;
+    switch (arg.kind) {
+      case LogArg::Kind::Int: n = std::snprintf(scratch, sizeof(scratch), "%lld", static_cast<long long>(arg.i)); break;
+      case LogArg::Kind::UInt: n = std::snprintf(scratch, sizeof(scratch), "%llu", static_cast<unsigned long long>(arg.u)); break;
+      case LogArg::Kind::Double: n = std::snprintf(scratch, sizeof(scratch), "%g", arg.d); break;
+      case LogArg::Kind::Pointer: n = std::snprintf(scratch, sizeof(scratch), "%p", arg.p); break;
+      case LogArg::Kind::Text: buffer_.append(record.text + arg.text.offset, arg.text.length); return;
+    }
+    buffer_.append(scratch, static_cast<size_t>(std::max(0, std::min(n, static_cast<int>(sizeof(scratch)) - 1))));
+  }
+};
+
+#define LOG_AT(level, ...)                                                   \
+  do {                                                                       \
+    if constexpr (level >= kCompiledLogLevel && level != LogLevel::Off) {   \
+      Logger::Instance().Log(level, __VA_ARGS__);                            \
+    }                                                                        \
+  } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LogLevel::Error, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -0,0 +1,211 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+#include "types.h"
+#include "grid_planning.h"
+
+using std::vector;
+
+/*
+  Bounded, sharded LRU cache of planner results keyed by (start, goal, board version).
+
+  Lookups hash the key to one of up to kShards shards, each with its own mutex, LRU list and hash map, so threads
+  querying different pairs rarely contend. Every shard holds capacity / shards entries (rounded down), and caches
+  smaller than kShards use one shard per entry, so the cache never holds more than `capacity` results (minimum 1).
+
+  Board changes are reported through OnTileChanged():
+    Free -> Blocked   can only make paths longer, and only paths through that tile. Entries whose path crosses it are
+                      erased (a bounding-box check skips most entries); every other entry stays valid, including
+                      cached "no path" results.
+    Blocked -> Free   can shorten any path or connect any pair, so the board version is bumped. Older entries can no
+                      longer be hit and age out of the LRU.
+*/
+class PathCache {
+public:
+  static constexpr size_t kShards = 16;
+
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidated;
+    uint64_t lookup_ns;  // time spent inside GetOrPlan() on hits
+    uint64_t plan_ns;    // time spent running the planner on misses
+
+    double HitRate() const { return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses); }
+    double MeanHitMicros() const { return hits == 0 ? 0.0 : lookup_ns / 1000.0 / hits; }
+    double MeanMissMicros() const { return misses == 0 ? 0.0 : plan_ns / 1000.0 / misses; }
+  };
+
+  explicit PathCache(size_t capacity)
+    : shard_count_{std::min(kShards, std::max<size_t>(1, capacity))},
+      shard_capacity_{std::max<size_t>(1, capacity) / shard_count_} {}
+
+  size_t Capacity() const { return shard_count_ * shard_capacity_; }
+
+  size_t Size() {
+    size_t size = 0;
+    for (size_t i = 0; i < shard_count_; i++) {
+      std::lock_guard<std::mutex> lock(shards_[i].mutex);
+      size += shards_[i].lru.size();
+    }
+    return size;
+  }
+
+  uint64_t Version() const { return version_.load(); }
+
+  /*
+    Returns the cached result for (start, goal) at the current board version, or runs planner() and caches its result.
+    planner is any callable returning a PathResult, e.g. [&] { return PlanPath(UnitCost(board), start, goal); }.
+  */
+  template <typename Planner>
+  PathResult GetOrPlan(const Coordinate& start, const Coordinate& goal, Planner planner) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto generation = generation_.load();
+    Key key {start.x, start.y, goal.x, goal.y, version_.load()};
+    auto& shard = ShardFor(key);
+
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.index.find(key);
+      if (it != shard.index.end()) {
+        // Move the entry to the front of the LRU list
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        PathResult result = it->second->result;
+        hits_++;
+        lookup_ns_ += Elapsed(t0);
+        return result;
+      }
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+    PathResult result = planner();
+    misses_++;
+    plan_ns_ += Elapsed(t1);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // A tile changed while planning: the result may already be stale, so return it without caching it
+    if (generation != generation_.load() || shard.index.count(key) != 0) return result;
+
+    shard.lru.push_front(Entry {key, result, Bounds(result)});
+    shard.index[key] = shard.lru.begin();
+    if (shard.lru.size() > shard_capacity_) {
+      shard.index.erase(shard.lru.back().key);
+      shard.lru.pop_back();
+    }
+    return result;
+  }
+
+  void OnTileChanged(const Coordinate& c, TileState state) {
+    generation_++;
+    if (state != TileState::Blocked) {
+      version_++;
+      return;
+    }
+
+    for (size_t i = 0; i < shard_count_; i++) {
+      auto& shard = shards_[i];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+        if (Crosses(*it, c)) {
+          shard.index.erase(it->key);
+          it = shard.lru.erase(it);
+          invalidated_++;
+        }
+        else {
+          ++it;
+        }
+      }
+    }
+  }
+
+  Stats GetStats() const {
+    return Stats {hits_.load(), misses_.load(), invalidated_.load(), lookup_ns_.load(), plan_ns_.load()};
+  }
+
+private:
+  struct Key {
+    int start_x, start_y, goal_x, goal_y;
+    uint64_t version;
+
+    bool operator==(const Key& other) const {
+      return start_x == other.start_x && start_y == other.start_y && goal_x == other.goal_x && goal_y == other.goal_y &&
+             version == other.version;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      // 64-bit FNV-1a style mixing of the five fields
+      uint64_t h = 14695981039346656037ull;
+      for (uint64_t v : {uint64_t(uint32_t(key.start_x)), uint64_t(uint32_t(key.start_y)), uint64_t(uint32_t(key.goal_x)),
+                         uint64_t(uint32_t(key.goal_y)), key.version}) {
+        h = (h ^ v) * 1099511628211ull;
+      }
+      return static_cast<size_t>(h ^ (h >> 32));
+    }
+  };
+
+  struct Box {
+    int min_x, min_y, max_x, max_y;
+  };
+
+  struct Entry {
+    Key key;
+    PathResult result;
+    Box bounds;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::list<Entry> lru;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+  };
+
+  size_t shard_count_;
+  size_t shard_capacity_;
+  Shard shards_[kShards];
+  std::atomic<uint64_t> version_ {0};
+  // Bumped on every tile change, including ones that do not bump version_
+  std::atomic<uint64_t> generation_ {0};
+  std::atomic<uint64_t> hits_ {0};
+  std::atomic<uint64_t> misses_ {0};
+  std::atomic<uint64_t> invalidated_ {0};
+  std::atomic<uint64_t> lookup_ns_ {0};
+  std::atomic<uint64_t> plan_ns_ {0};
+
+  Shard& ShardFor(const Key& key) { return shards_[KeyHash {}(key) % shard_count_]; }
+
+  static uint64_t Elapsed(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count();
+  }
+
+  static Box Bounds(const PathResult& result) {
+    Box box {INT_MAX, INT_MAX, INT_MIN, INT_MIN};
+    for (const auto& c : result.cells) {
+      box.min_x = std::min(box.min_x, c.x);
+      box.min_y = std::min(box.min_y, c.y);
+      box.max_x = std::max(box.max_x, c.x);
+      box.max_y = std::max(box.max_y, c.y);
+    }
+    return box;
+  }
+
+  static bool Crosses(const Entry& entry, const Coordinate& c) {
+    const auto& box = entry.bounds;
+    if (c.x < box.min_x || c.x > box.max_x || c.y < box.min_y || c.y > box.max_y) return false;
+    return std::any_of(entry.result.cells.begin(), entry.result.cells.end(),
+                       [&c](const Coordinate& cell) { return cell.x == c.x && cell.y == c.y; });
+  }
+};
+
+#endif // PATH_CACHE_H
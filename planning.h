@@ -7,6 +7,7 @@
 
 #include "types.h"
 #include "functions.h"
+#include "logger.h"
 
 using std::cout;
 using std::vector;
@@ -78,7 +79,8 @@ bool CheckValidCell(const Coordinate& c, const vector<vector<TileState>>& grid)
     return false;
 }
 
-void ExpandNeighbors(const Node& current_node, vector<Node>& open_nodes, vector<vector<TileState>>& grid, const Coordinate& goal) {
+template <typename Heuristic>
+void ExpandNeighbors(const Node& current_node, vector<Node>& open_nodes, vector<vector<TileState>>& grid, const Coordinate& goal, const Heuristic& heuristic) {
   // Iterating through constant array defined at the top
   for (auto& d : delta) {
     auto current_coordinate = Coordinate {
@@ -90,7 +92,7 @@ void ExpandNeighbors(const Node& current_node, vector<Node>& open_nodes, vector<
       auto neighbor = Node {
         current_coordinate,
         current_node.g + 1,
-        Distance(current_coordinate, goal)
+        heuristic(current_coordinate, goal)
       };
 
       AddToOpen(neighbor, open_nodes, grid);
@@ -98,11 +100,19 @@ void ExpandNeighbors(const Node& current_node, vector<Node>& open_nodes, vector<
   }
 }
 
-vector<vector<TileState>> Search(vector<vector<TileState>>& grid, const Coordinate& start, const Coordinate& goal) {
+void ExpandNeighbors(const Node& current_node, vector<Node>& open_nodes, vector<vector<TileState>>& grid, const Coordinate& goal) {
+  ExpandNeighbors(current_node, open_nodes, grid, goal, Distance);
+}
+
+template <typename Heuristic>
+vector<vector<TileState>> Search(vector<vector<TileState>>& grid, const Coordinate& start, const Coordinate& goal, const Heuristic& heuristic) {
   /*
+    The heuristic is any callable int(const Coordinate& cell, const Coordinate& goal) that never overestimates the
+    remaining distance, e.g. Distance() or the precomputed tables in heuristics.h.
+    It is a template parameter rather than a std::function so the call is inlined on every neighbor expansion.
   */
   if (grid.empty()) {
-    cout << "Please provide a non-empty grid.\n";
+    LOG_WARNING("Please provide a non-empty grid.");
     return grid;
   }
 
@@ -111,7 +121,7 @@ vector<vector<TileState>> Search(vector<vector<TileState>>& grid, const Coordina
   auto first_node = Node {
     start,
     0,
-    Distance(start, goal)
+    heuristic(start, goal)
   };
 
   AddToOpen(first_node, open_nodes, grid);
@@ -139,13 +149,17 @@ vector<vector<TileState>> Search(vector<vector<TileState>>& grid, const Coordina
       return grid;
     }
 
-    ExpandNeighbors(closest, open_nodes, grid, goal);
+    ExpandNeighbors(closest, open_nodes, grid, goal, heuristic);
   }
 
-  cout << "No path found.\n";
+  LOG_INFO("No path found.");
   return grid;
 }
 
+vector<vector<TileState>> Search(vector<vector<TileState>>& grid, const Coordinate& start, const Coordinate& goal) {
+  return Search(grid, start, goal, Distance);
+}
+
 /*
   In A Tour of C++, Bjarne Stroustrup writes:
 
@@ -0,0 +1,299 @@
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <future>
+#include <thread>
+#include <utility>
+
+#include "types.h"
+#include "functions.h"
+#include "geometry.h"
+
+using std::vector;
+using std::size_t;
+
+/*
+  Spatial indexes over a PointBuffer for radius ("which points are within r of X") and k-nearest-neighbour queries.
+
+  Both indexes are bulk-built once and then read-only, so every structure is a handful of flat arrays:
+  no per-node allocations and no pointers to chase. Results are indices into the PointBuffer the index was built from.
+
+  UniformGrid - buckets points into square cells with a counting sort. Best for radius queries when r is close to the cell size.
+  KdTree      - implicit balanced k-d tree (median split, children are the two halves of the array). Handles clustered data
+                and k-nearest-neighbour queries well.
+*/
+
+class UniformGrid {
+public:
+  UniformGrid(const PointBuffer& points, float cell_size) : cell_size_{cell_size}, inv_cell_{1.0f / cell_size} {
+    Build(points);
+  }
+
+  // The cell size actually used; larger than requested when the requested one would need too many cells
+  float CellSize() const noexcept { return cell_size_; }
+
+  void QueryRadius(const Point& q, float r, vector<size_t>& out) const {
+    out.clear();
+    if (cells_x_ == 0) return;
+
+    const float r2 = r * r;
+    const int x0 = std::max(0, CellX(q.X() - r)), x1 = std::min(cells_x_ - 1, CellX(q.X() + r));
+    const int y0 = std::max(0, CellY(q.Y() - r)), y1 = std::min(cells_y_ - 1, CellY(q.Y() + r));
+
+    for (int cy = y0; cy <= y1; cy++) {
+      for (int cx = x0; cx <= x1; cx++) {
+        const auto cell = static_cast<size_t>(cy) * cells_x_ + cx;
+        for (auto i = cell_start_[cell]; i < cell_start_[cell + 1]; i++) {
+          const float dx = xs_[i] - q.X(), dy = ys_[i] - q.Y();
+          if (dx * dx + dy * dy <= r2) out.push_back(ids_[i]);
+        }
+      }
+    }
+  }
+
+  void QueryRadiusBatch(const vector<Point>& queries, float r, vector<vector<size_t>>& results) const {
+    results.resize(queries.size());
+    ParallelFor(queries.size(), [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++) QueryRadius(queries[i], r, results[i]);
+    }, 64);
+  }
+
+private:
+  float cell_size_;
+  float inv_cell_;
+  Point origin_ {0, 0};
+  int cells_x_ {0};
+  int cells_y_ {0};
+  // Points of cell c live in [cell_start_[c], cell_start_[c + 1]) of xs_/ys_/ids_
+  vector<uint32_t> cell_start_;
+  vector<float> xs_;
+  vector<float> ys_;
+  vector<size_t> ids_;
+
+  // At most kCellsPerPoint cells per point, so a tiny cell size over a wide spread cannot exhaust memory or overflow the cell ids
+  static constexpr size_t kCellsPerPoint = 4;
+
+  // Clamped to [-1, cells] before the cast, so query circles far outside the grid cannot overflow int
+  int CellX(float x) const { return Clamp(std::floor((x - origin_.X()) * inv_cell_), cells_x_); }
+  int CellY(float y) const { return Clamp(std::floor((y - origin_.Y()) * inv_cell_), cells_y_); }
+
+  static int Clamp(float cell, int cells) {
+    return static_cast<int>(std::min(std::max(cell, -1.0f), static_cast<float>(cells)));
+  }
+
+  void Build(const PointBuffer& points) {
+    /*
+      Counting sort in three passes:
+        1. compute each point's cell (parallel),
+        2. count points per cell and prefix-sum the counts into cell_start_,
+        3. scatter the points into their cell's slice so each cell is contiguous in memory.
+    */
+    const auto n = points.Size();
+    if (n == 0) return;
+
+    auto box = points.Bounds();
+    origin_ = box.min;
+    const double width = static_cast<double>(box.max.X()) - box.min.X();
+    const double height = static_cast<double>(box.max.Y()) - box.min.Y();
+    const auto max_cells = static_cast<double>(std::min<size_t>(n * kCellsPerPoint, UINT32_MAX / 2));
+    const auto cells_along = [](double extent, double cell) { return std::floor(extent / cell) + 1.0; };
+
+    // A non-positive or non-finite cell size is meaningless; start from one cell for the whole extent instead
+    double cell = cell_size_;
+    if (!(cell > 0.0) || !std::isfinite(cell)) cell = std::max({width, height, 1.0});
+    while (cells_along(width, cell) * cells_along(height, cell) > max_cells) cell *= 2.0;
+    cell_size_ = static_cast<float>(cell);
+    inv_cell_ = 1.0f / cell_size_;
+
+    cells_x_ = static_cast<int>(cells_along(width, cell));
+    cells_y_ = static_cast<int>(cells_along(height, cell));
+    const auto cell_count = static_cast<size_t>(cells_x_) * cells_y_;
+
+    vector<uint32_t> cell_of(n);
+    const float* px = points.Xs();
+    const float* py = points.Ys();
+    ParallelFor(n, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++) {
+        // Float rounding can put a point on the far edge one past the last cell
+        const auto cx = std::min(cells_x_ - 1, CellX(px[i])), cy = std::min(cells_y_ - 1, CellY(py[i]));
+        cell_of[i] = static_cast<uint32_t>(cy * cells_x_ + cx);
+      }
+    });
+
+    cell_start_.assign(cell_count + 1, 0);
+    for (auto cell : cell_of) cell_start_[cell + 1]++;
+    std::partial_sum(cell_start_.begin(), cell_start_.end(), cell_start_.begin());
+
+    xs_.resize(n);
+    ys_.resize(n);
+    ids_.resize(n);
+    vector<uint32_t> cursor(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < n; i++) {
+      auto slot = cursor[cell_of[i]]++;
+      xs_[slot] = px[i];
+      ys_[slot] = py[i];
+      ids_[slot] = i;
+    }
+  }
+};
+
+class KdTree {
+public:
+  explicit KdTree(const PointBuffer& points) { Build(points); }
+
+  size_t Size() const noexcept { return ids_.size(); }
+
+  void QueryRadius(const Point& q, float r, vector<size_t>& out) const {
+    out.clear();
+    if (ids_.empty()) return;
+
+    const float r2 = r * r;
+    Range stack[64];
+    int top = 0;
+    stack[top++] = Range {0, ids_.size(), 0};
+
+    while (top > 0) {
+      auto range = stack[--top];
+      if (range.hi - range.lo <= kLeafSize) {
+        for (auto i = range.lo; i < range.hi; i++) {
+          const float dx = xs_[i] - q.X(), dy = ys_[i] - q.Y();
+          if (dx * dx + dy * dy <= r2) out.push_back(ids_[i]);
+        }
+        continue;
+      }
+
+      const auto mid = range.lo + (range.hi - range.lo) / 2;
+      const float dx = xs_[mid] - q.X(), dy = ys_[mid] - q.Y();
+      if (dx * dx + dy * dy <= r2) out.push_back(ids_[mid]);
+
+      const float diff = (range.depth % 2 == 0) ? q.X() - xs_[mid] : q.Y() - ys_[mid];
+      if (diff - r <= 0) stack[top++] = Range {range.lo, mid, range.depth + 1};
+      if (diff + r >= 0) stack[top++] = Range {mid + 1, range.hi, range.depth + 1};
+    }
+  }
+
+  // k nearest points to q, closest first
+  void Nearest(const Point& q, size_t k, vector<size_t>& out) const {
+    out.clear();
+    if (ids_.empty() || k == 0) return;
+
+    // Max-heap on squared distance holding the best k candidates found so far
+    vector<std::pair<float, size_t>> best;
+    best.reserve(k + 1);
+    NearestRecursive(q, k, 0, ids_.size(), 0, best);
+
+    std::sort_heap(best.begin(), best.end());
+    for (const auto& candidate : best) out.push_back(ids_[candidate.second]);
+  }
+
+  void QueryRadiusBatch(const vector<Point>& queries, float r, vector<vector<size_t>>& results) const {
+    results.resize(queries.size());
+    ParallelFor(queries.size(), [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++) QueryRadius(queries[i], r, results[i]);
+    }, 64);
+  }
+
+  void NearestBatch(const vector<Point>& queries, size_t k, vector<vector<size_t>>& results) const {
+    results.resize(queries.size());
+    ParallelFor(queries.size(), [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++) Nearest(queries[i], k, results[i]);
+    }, 64);
+  }
+
+private:
+  static constexpr size_t kLeafSize = 16;
+  // Subtrees below this many points are built on the calling thread
+  static constexpr size_t kParallelBuildCutoff = 1 << 16;
+
+  struct Range {
+    size_t lo;
+    size_t hi;
+    int depth;
+  };
+
+  // Points in tree order: node [lo, hi) splits at mid = lo + (hi - lo) / 2 on x for even depths, y for odd depths
+  vector<float> xs_;
+  vector<float> ys_;
+  vector<size_t> ids_;
+
+  void Build(const PointBuffer& points) {
+    const auto n = points.Size();
+    ids_.resize(n);
+    std::iota(ids_.begin(), ids_.end(), size_t{0});
+
+    auto depth_limit = 0;
+    for (auto threads = std::thread::hardware_concurrency(); threads > 1; threads /= 2) depth_limit++;
+    BuildRecursive(points, 0, n, 0, depth_limit);
+
+    xs_.resize(n);
+    ys_.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      xs_[i] = points.Xs()[ids_[i]];
+      ys_[i] = points.Ys()[ids_[i]];
+    }
+  }
+
+  void BuildRecursive(const PointBuffer& points, size_t lo, size_t hi, int depth, int parallel_depth) {
+    if (hi - lo <= kLeafSize) return;
+
+    const auto mid = lo + (hi - lo) / 2;
+    const float* axis = (depth % 2 == 0) ? points.Xs() : points.Ys();
+    std::nth_element(ids_.begin() + lo, ids_.begin() + mid, ids_.begin() + hi,
+                     [axis](size_t a, size_t b) { return axis[a] < axis[b]; });
+
+    // The two halves are disjoint slices of ids_, so they can be partitioned concurrently
+    if (parallel_depth > 0 && hi - lo >= kParallelBuildCutoff) {
+      auto left = std::async(std::launch::async, &KdTree::BuildRecursive, this, std::cref(points), lo, mid, depth + 1, parallel_depth - 1);
+      BuildRecursive(points, mid + 1, hi, depth + 1, parallel_depth - 1);
+      left.wait();
+    }
+    else {
+      BuildRecursive(points, lo, mid, depth + 1, 0);
+      BuildRecursive(points, mid + 1, hi, depth + 1, 0);
+    }
+  }
+
+  void Offer(float d2, size_t index, size_t k, vector<std::pair<float, size_t>>& best) const {
+    if (best.size() < k) {
+      best.emplace_back(d2, index);
+      std::push_heap(best.begin(), best.end());
+    }
+    else if (d2 < best.front().first) {
+      std::pop_heap(best.begin(), best.end());
+      best.back() = {d2, index};
+      std::push_heap(best.begin(), best.end());
+    }
+  }
+
+  void NearestRecursive(const Point& q, size_t k, size_t lo, size_t hi, int depth, vector<std::pair<float, size_t>>& best) const {
+    if (hi - lo <= kLeafSize) {
+      for (auto i = lo; i < hi; i++) {
+        const float dx = xs_[i] - q.X(), dy = ys_[i] - q.Y();
+        Offer(dx * dx + dy * dy, i, k, best);
+      }
+      return;
+    }
+
+    const auto mid = lo + (hi - lo) / 2;
+    const float dx = xs_[mid] - q.X(), dy = ys_[mid] - q.Y();
+    Offer(dx * dx + dy * dy, mid, k, best);
+
+    // Descend into the side containing q first, then visit the other side only if it can still hold a closer point
+    const float diff = (depth % 2 == 0) ? q.X() - xs_[mid] : q.Y() - ys_[mid];
+    const bool left_first = diff < 0;
+    if (left_first) NearestRecursive(q, k, lo, mid, depth + 1, best);
+    else NearestRecursive(q, k, mid + 1, hi, depth + 1, best);
+
+    if (best.size() < k || diff * diff < best.front().first) {
+      if (left_first) NearestRecursive(q, k, mid + 1, hi, depth + 1, best);
+      else NearestRecursive(q, k, lo, mid, depth + 1, best);
+    }
+  }
+};
+
+#endif // SPATIAL_H
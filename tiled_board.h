@@ -0,0 +1,271 @@
+#ifndef TILED_BOARD_H
+#define TILED_BOARD_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "types.h"
+#include "logger.h"
+
+using std::string;
+using std::vector;
+
+/*
+  Out-of-core board storage for maps larger than memory (POSIX only: mmap/posix_fadvise).
+
+  The map is cut into fixed-size square tiles stored one after another on disk, one byte per cell holding the terrain
+  cost (0 = blocked, same meaning as ReadCostFile()). Edge tiles are padded with blocked cells so every tile has the
+  same size and tile t starts at kHeaderBytes + t * tile_bytes.
+
+  TiledBoard maps tiles into memory on first access and keeps at most max_resident_tiles of them, unmapping the least
+  recently used one when the budget is exceeded. When the search steps from one tile into an adjacent one that is not
+  resident, the tile after it in the same direction is handed to posix_fadvise(WILLNEED), so the kernel reads ahead
+  in the direction the frontier is crossing tile boundaries. A load with no adjacent predecessor (the first one, or a
+  jump across the map) prefetches all four neighbours instead.
+
+  It exposes the same Rows()/Cols()/operator()(x, y) interface as TileCost, so PlanPath() runs on it unchanged; the
+  NodePool it searches with only allocates state for the tiles the search reaches. Lookups update the LRU state, so a
+  TiledBoard must not be shared between threads.
+
+  PlanPath() numbers cells with 32-bit ids and refuses boards whose tile-padded size exceeds INT_MAX cells (about
+  46000 x 46000); larger maps have to be split into separately planned regions.
+
+  Like ReadBoardFile(), bad input is reported and yields an empty board: a file with an impossible header or shorter
+  than its header promises loads as 0x0, on which every search fails. Costs that do not fit in a byte are refused by
+  WriteTiledBoard() rather than clamped.
+*/
+
+const char kTiledBoardMagic[4] = {'T', 'I', 'L', 'E'};
+const size_t kHeaderBytes = 4096;
+// One byte per cell, so costs above 255 cannot be stored
+const int kMaxTiledCost = 255;
+const int kMaxTileSize = 1 << 14;
+
+template <typename CostAt>
+bool WriteTiledBoard(const string& file_path, int rows, int cols, int tile_size, CostAt cost_at) {
+  /*
+    cost_at(x, y) returns the terrain cost of a cell. Tiles are written one at a time, so a map much larger than memory
+    can be generated without ever holding it all.
+  */
+  if (rows < 0 || cols < 0 || tile_size <= 0 || tile_size > kMaxTileSize) {
+    LOG_WARNING("Cannot write a {}x{} board with tile size {}.", rows, cols, tile_size);
+    return false;
+  }
+
+  std::ofstream file(file_path, std::ios::binary);
+  if (!file) {
+    LOG_WARNING("Path {} could not be opened for writing.", file_path);
+    return false;
+  }
+
+  vector<char> header(kHeaderBytes, 0);
+  int32_t fields[3] = {rows, cols, tile_size};
+  std::memcpy(header.data(), kTiledBoardMagic, sizeof(kTiledBoardMagic));
+  std::memcpy(header.data() + sizeof(kTiledBoardMagic), fields, sizeof(fields));
+  file.write(header.data(), header.size());
+
+  vector<uint8_t> tile(static_cast<size_t>(tile_size) * tile_size);
+  for (int tile_x = 0; tile_x < rows; tile_x += tile_size) {
+    for (int tile_y = 0; tile_y < cols; tile_y += tile_size) {
+      for (int dx = 0; dx < tile_size; dx++) {
+        for (int dy = 0; dy < tile_size; dy++) {
+          auto x = tile_x + dx, y = tile_y + dy;
+          auto cost = (x < rows && y < cols) ? cost_at(x, y) : 0;
+          if (cost < 0 || cost > kMaxTiledCost) {
+            // Clamping would make the tiled board disagree with the in-memory one, so refuse and drop the partial file
+            LOG_WARNING("Cost {} at ({}, {}) does not fit in a tiled board cell.", cost, x, y);
+            file.close();
+            std::remove(file_path.c_str());
+            return false;
+          }
+          tile[dx * tile_size + dy] = static_cast<uint8_t>(cost);
+        }
+      }
+      file.write(reinterpret_cast<const char*>(tile.data()), tile.size());
+    }
+  }
+  return static_cast<bool>(file);
+}
+
+bool WriteTiledBoard(const string& file_path, const vector<vector<int>>& costs, int tile_size) {
+  auto rows = static_cast<int>(costs.size());
+  auto cols = costs.empty() ? 0 : static_cast<int>(costs[0].size());
+  return WriteTiledBoard(file_path, rows, cols, tile_size, [&costs](int x, int y) { return costs[x][y]; });
+}
+
+class TiledBoard {
+public:
+  static constexpr bool kUniform = false;
+
+  TiledBoard(const string& file_path, size_t max_resident_tiles) : max_resident_{std::max<size_t>(1, max_resident_tiles)} {
+    fd_ = open(file_path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      LOG_WARNING("Path {} does not exist or could not be found.", file_path);
+      return;
+    }
+
+    char header[sizeof(kTiledBoardMagic) + 3 * sizeof(int32_t)];
+    int32_t fields[3];
+    if (pread(fd_, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header, kTiledBoardMagic, sizeof(kTiledBoardMagic)) != 0) {
+      LOG_WARNING("{} is not a tiled board file.", file_path);
+      return;
+    }
+    std::memcpy(fields, header + sizeof(kTiledBoardMagic), sizeof(fields));
+    const auto rows = fields[0], cols = fields[1], tile_size = fields[2];
+    if (rows < 0 || cols < 0 || tile_size <= 0 || tile_size > kMaxTileSize) {
+      LOG_WARNING("{} has an invalid header.", file_path);
+      return;
+    }
+
+    // A file cut short would map fine and then fault (SIGBUS) on the first read past its end
+    const auto tile_rows = (static_cast<uint64_t>(rows) + tile_size - 1) / tile_size;
+    const auto tile_cols = (static_cast<uint64_t>(cols) + tile_size - 1) / tile_size;
+    const auto expected = kHeaderBytes + tile_rows * tile_cols * tile_size * tile_size;
+    struct stat info;
+    if (fstat(fd_, &info) != 0 || static_cast<uint64_t>(info.st_size) < expected) {
+      LOG_WARNING("{} is truncated.", file_path);
+      return;
+    }
+
+    // Only a fully validated board gets non-zero dimensions; until then every cell is out of bounds
+    rows_ = rows;
+    cols_ = cols;
+    tile_size_ = tile_size;
+    tiles_per_row_ = static_cast<int>(tile_cols);
+    tile_bytes_ = static_cast<size_t>(tile_size_) * tile_size_;
+    page_size_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  ~TiledBoard() {
+    for (auto& entry : resident_) Unmap(entry.second);
+    if (fd_ >= 0) close(fd_);
+  }
+
+  TiledBoard(const TiledBoard&) = delete;
+  TiledBoard& operator=(const TiledBoard&) = delete;
+
+  int Rows() const { return rows_; }
+  int Cols() const { return cols_; }
+  int TileSize() const { return tile_size_; }
+
+  int operator()(int x, int y) const {
+    const auto tile = (x / tile_size_) * tiles_per_row_ + (y / tile_size_);
+    // Searches touch the same tile many times in a row, so the hash lookup and LRU update only happen on a tile switch
+    if (tile != last_tile_) {
+      last_data_ = Acquire(tile, last_tile_);
+      last_tile_ = tile;
+    }
+    return last_data_[(x % tile_size_) * tile_size_ + (y % tile_size_)];
+  }
+
+  size_t TileLoads() const noexcept { return loads_; }
+  size_t Evictions() const noexcept { return evictions_; }
+  size_t Prefetches() const noexcept { return prefetches_; }
+  size_t ResidentTiles() const noexcept { return resident_.size(); }
+  size_t ResidentBytes() const noexcept { return resident_.size() * tile_bytes_; }
+
+private:
+  struct Mapping {
+    void* address;
+    size_t length;
+    const uint8_t* data;
+    std::list<int>::iterator lru;
+  };
+
+  int fd_ {-1};
+  int rows_ {0};
+  int cols_ {0};
+  int tile_size_ {1};
+  int tiles_per_row_ {0};
+  size_t tile_bytes_ {0};
+  size_t page_size_ {4096};
+  size_t max_resident_;
+
+  // Most recently used tile at the front
+  mutable std::list<int> lru_;
+  mutable std::unordered_map<int, Mapping> resident_;
+  mutable int last_tile_ {-1};
+  mutable const uint8_t* last_data_ {nullptr};
+  mutable size_t loads_ {0};
+  mutable size_t evictions_ {0};
+  mutable size_t prefetches_ {0};
+
+  off_t TileOffset(int tile) const { return static_cast<off_t>(kHeaderBytes + static_cast<size_t>(tile) * tile_bytes_); }
+
+  const uint8_t* Acquire(int tile, int previous) const {
+    auto it = resident_.find(tile);
+    if (it != resident_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+      return it->second.data;
+    }
+
+    if (resident_.size() >= max_resident_) {
+      auto victim = lru_.back();
+      Unmap(resident_[victim]);
+      resident_.erase(victim);
+      lru_.pop_back();
+      evictions_++;
+    }
+
+    // mmap offsets must be page aligned, so map from the page containing the start of the tile
+    auto offset = TileOffset(tile);
+    auto aligned = offset - offset % static_cast<off_t>(page_size_);
+    auto length = tile_bytes_ + static_cast<size_t>(offset - aligned);
+    void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd_, aligned);
+    if (address == MAP_FAILED) {
+      // Callers index into the returned tile, so there is no way to report this as a blocked cell; give up loudly
+      throw std::runtime_error("Could not map tile " + std::to_string(tile));
+    }
+
+    lru_.push_front(tile);
+    auto data = static_cast<const uint8_t*>(address) + (offset - aligned);
+    resident_.emplace(tile, Mapping {address, length, data, lru_.begin()});
+    loads_++;
+    Prefetch(tile, previous);
+    return data;
+  }
+
+  void Prefetch(int tile, int previous) const {
+    const int tx = tile / tiles_per_row_, ty = tile % tiles_per_row_;
+    if (previous >= 0) {
+      const int step_x = tx - previous / tiles_per_row_, step_y = ty - previous % tiles_per_row_;
+      if (std::abs(step_x) <= 1 && std::abs(step_y) <= 1) {
+        PrefetchTile(tx + step_x, ty + step_y);
+        return;
+      }
+    }
+    PrefetchTile(tx - 1, ty);
+    PrefetchTile(tx + 1, ty);
+    PrefetchTile(tx, ty - 1);
+    PrefetchTile(tx, ty + 1);
+  }
+
+  void PrefetchTile(int tx, int ty) const {
+    const auto tile_rows = (rows_ + tile_size_ - 1) / tile_size_;
+    if (tx < 0 || tx >= tile_rows || ty < 0 || ty >= tiles_per_row_) return;
+    auto tile = tx * tiles_per_row_ + ty;
+    if (resident_.count(tile) == 0) {
+      posix_fadvise(fd_, TileOffset(tile), static_cast<off_t>(tile_bytes_), POSIX_FADV_WILLNEED);
+      prefetches_++;
+    }
+  }
+
+  void Unmap(const Mapping& mapping) const { munmap(mapping.address, mapping.length); }
+};
+
+#endif // TILED_BOARD_H
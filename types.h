@@ -5,6 +5,8 @@
 #include <string>
 #include <deque>
 
+#include "logger.h"
+
 enum class TileState {
     Free, 
     Blocked,
@@ -119,22 +121,41 @@ private:
 
 class Point {
 public:
-    Point(float x, float y) : x_{x}, y_{y} {}
+    constexpr Point(float x, float y) : x_{x}, y_{y} {}
     
-    Point operator+(const Point& point) { 
+    constexpr Point operator+(const Point& point) const { 
         auto new_x = x_ + point.X();
         auto new_y = y_ + point.Y();
         return Point(new_x, new_y);
     }
+
+    constexpr Point operator-(const Point& point) const {
+        return Point(x_ - point.X(), y_ - point.Y());
+    }
+
+    constexpr Point operator*(float factor) const {
+        return Point(x_ * factor, y_ * factor);
+    }
+
+    constexpr Point& operator+=(const Point& point) {
+        x_ += point.X();
+        y_ += point.Y();
+        return *this;
+    }
+
+    constexpr bool operator==(const Point& point) const { return x_ == point.X() && y_ == point.Y(); }
+    constexpr bool operator!=(const Point& point) const { return !(*this == point); }
     
-    float X() const noexcept { return x_; }
-    float Y() const noexcept { return y_; }
+    constexpr float X() const noexcept { return x_; }
+    constexpr float Y() const noexcept { return y_; }
     
 private:
     float x_;
     float y_;
 };
 
+constexpr Point operator*(float factor, const Point& point) { return point * factor; }
+
 class MyMovableClass
 {
 private:
@@ -146,18 +167,18 @@ public:
     {
         _size = size;
         _data = new int[_size];
-        std::cout << "CREATING instance of MyMovableClass at " << this << " allocated with size = " << _size*sizeof(int)  << " bytes" << std::endl;
+        LOG_DEBUG("CREATING instance of MyMovableClass at {} allocated with size = {} bytes", this, _size*sizeof(int));
     }
 
     ~MyMovableClass() // 1 : destructor
     {
-        std::cout << "DELETING instance of MyMovableClass at " << this << std::endl;
+        LOG_DEBUG("DELETING instance of MyMovableClass at {}", this);
         delete[] _data;
     }
     
     MyMovableClass(MyMovableClass&& source) // 2 : move constructor
     {
-        std::cout << "MOVING (constructor) instance " << &source << " to instance " << this << std::endl;
+        LOG_DEBUG("MOVING (constructor) instance {} to instance {}", &source, this);
         _data = source._data; // makes a copy of the pointer to the existing memory address
         _size = source._size; // regular copy
         source._data = nullptr; // ensures there is only 1 pointer in this new instance and prevents the destructor from deleting the no longer owned data
@@ -171,12 +192,12 @@ public:
         _size = source._size;
         _data = new int[_size];
         *_data = *source._data;
-        std::cout << "COPYING content of instance " << &source << " to instance " << this << std::endl;
+        LOG_DEBUG("COPYING content of instance {} to instance {}", &source, this);
     }
     
     MyMovableClass& operator=(const MyMovableClass& source) // 4 : copy assignment operator
     {
-        std::cout << "ASSIGNING content of instance " << &source << " to instance " << this << std::endl;
+        LOG_DEBUG("ASSIGNING content of instance {} to instance {}", &source, this);
         if (this == &source)
             return *this;
         delete[] _data;
@@ -188,7 +209,7 @@ public:
 
     MyMovableClass& operator=(MyMovableClass&& source) // 5 : move assignment operator
     {
-        std::cout << "MOVING (assign) instance " << &source << " to instance " << this << std::endl;
+        LOG_DEBUG("MOVING (assign) instance {} to instance {}", &source, this);
         
         if (this == &source)
             return *this;
@@ -246,8 +267,8 @@ public:
         // perform vector modification under the lock
         std::lock_guard<std::mutex> uLock(_mutex);
 
-        // add vector to queue
-        std::cout << "   Message #" << v.getID() << " will be added to the queue" << std::endl;
+        // add vector to queue (the logger formats and prints on its own thread, so the lock is not held during I/O)
+        LOG_INFO("   Message #{} will be added to the queue", v.getID());
         _messages.push_back(std::move(v));
         _cond.notify_one(); // notify client after pushing new Vehicle into vector
     }